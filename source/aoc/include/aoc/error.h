@@ -5,7 +5,14 @@
 
 namespace aoc
 {
-    class aoc_exception : std::exception { using std::exception::exception; };
+    class aoc_exception : std::exception {
+    public:
+        aoc_exception() noexcept = default;
+        explicit aoc_exception(const char* msg) noexcept : msg_(msg) {}
+        const char* what() const noexcept override { return msg_; }
+    private:
+        const char* msg_ = "aoc exception";
+    };
 
     class parse_exception : public aoc_exception { using aoc_exception::aoc_exception; };
 
@@ -0,0 +1,26 @@
+#ifndef INCLUDE_GUARD__AOC_PART_CACHE_H__GUID_00935e99_23b3_414a_9442_68e161a2ce14
+#define INCLUDE_GUARD__AOC_PART_CACHE_H__GUID_00935e99_23b3_414a_9442_68e161a2ce14
+
+#include <optional>
+#include <utility>
+
+namespace aoc
+{
+    // Work shared by both parts of a day, kept in its input: the first part needing it computes it
+    // (and is timed with it), the other one reuses it. Thus parsing only parses. The parts of a day
+    // run one after the other, so it needs no synchronization.
+    template<typename T>
+    class part_cache {
+    public:
+        template<typename F>
+        const T& get(F&& compute) const {
+            if (!value_) value_.emplace(std::forward<F>(compute)());
+            return *value_;
+        }
+
+    private:
+        mutable std::optional<T> value_;
+    };
+}
+
+#endif // INCLUDE_GUARD__AOC_PART_CACHE_H__GUID_00935e99_23b3_414a_9442_68e161a2ce14
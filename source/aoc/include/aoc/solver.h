@@ -5,6 +5,11 @@
 #include <iosfwd>
 #include <chrono>
 #include <tuple>
+#include <memory>
+#include <optional>
+#include <array>
+#include <utility>
+#include <string_view>
 
 #include <aoc/serialize.h>
 #include <aoc/error.h>
@@ -24,6 +29,24 @@ namespace aoc
 
     int solve(int argc, char** argv, const solver_interface& solver) noexcept;
 
+    // name given with --engine, empty if none
+    std::string_view requested_engine() noexcept;
+
+    // Engine of a day with several ones, given as (name, engine) pairs: the one named by --engine,
+    // or the first one if none was requested. Days call it while parsing, so that an unknown
+    // name fails there. Days with a single engine ignore --engine.
+    template<typename Engine, std::size_t N>
+    Engine select_engine(const std::array<std::pair<std::string_view, Engine>, N>& engines)
+    {
+        static_assert(N > 0);
+        auto name = requested_engine();
+        if (name.empty()) return engines[0].second;
+        for (const auto&[n, e] : engines) {
+            if (n == name) return e;
+        }
+        throw parse_exception{ "unknown engine" };
+    }
+
     template<std::size_t YEAR, std::size_t DAY>
     auto create_solver() noexcept -> std::unique_ptr<solver_interface>;
 
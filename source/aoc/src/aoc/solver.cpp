@@ -10,12 +10,23 @@
 #include <map>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <string_view>
+#include <cstdlib>
+#include <charconv>
+#include <system_error>
 
 #include <ddr/porting.h>
+#include <ddr/parallel/thread_pool.h>
 
 namespace aoc {
 
     namespace {
+        std::string& engine_name() noexcept {
+            static std::string name;
+            return name;
+        }
+
         struct annotated_fstream {
             std::filesystem::path fpath;
             std::ifstream stream;
@@ -47,7 +58,7 @@ namespace aoc {
         }
 
         void print_exception(std::ostream& os, aoc_exception& e) noexcept {
-            os << "an exception has occurred" << std::endl;
+            os << "an exception has occurred: " << e.what() << std::endl;
         }
 
         void print_exception(config& cfg, aoc_exception& e) noexcept {
@@ -58,11 +69,32 @@ namespace aoc {
         {
             namespace fs = std::filesystem;
 
-            if (argc != 2) {
-                throw parse_exception{};
+            // usage: <input directory> [--threads N] [--engine NAME]
+            std::optional<std::string> input_dir;
+            for (int i = 1; i < argc; ++i) {
+                std::string_view arg = argv[i];
+                if (arg == "--threads") {
+                    // between 1 and a few threads per core, anything else is most likely a typo
+                    constexpr const char* usage = "usage: <input directory> [--threads N], N from 1 to 4 times the hardware concurrency";
+                    if (++i >= argc) throw parse_exception{ usage };
+                    std::string_view value = argv[i];
+                    std::size_t threads = 0;
+                    auto[last, ec] = std::from_chars(value.data(), value.data() + value.size(), threads);
+                    if (ec != std::errc{} || last != value.data() + value.size()) throw parse_exception{ usage };
+                    if (threads == 0 || threads > 4 * ddr::parallel::thread_pool::hardware_concurrency()) throw parse_exception{ usage };
+                    ddr::parallel::set_default_concurrency(threads);
+                } else if (arg == "--engine") {
+                    if (++i >= argc || *argv[i] == '\0') throw parse_exception{ "usage: <input directory> [--engine NAME]" };
+                    engine_name() = argv[i];
+                } else if (!input_dir) {
+                    input_dir = std::string(arg);
+                } else {
+                    throw parse_exception{};
+                }
             }
+            if (!input_dir) throw parse_exception{};
 
-            std::filesystem::path fpath = fs::u8path(argv[1]);
+            std::filesystem::path fpath = fs::u8path(*input_dir);
 
             // load all *.in, *.outA, *.outB files inside, e.g., "aoc18/d01"
             fpath /= "aoc";
@@ -123,8 +155,8 @@ namespace aoc {
                     ss << "(" << time.count() << " us)";
                     os << "parse: " << std::right << std::setw(TIME_WIDTH) << ss.str();
                 }
-                catch (aoc_exception&) {
-                    os << "ERROR - could not parse input" << std::endl;
+                catch (aoc_exception& e) {
+                    os << "ERROR - could not parse input (" << e.what() << ")" << std::endl;
                     continue;
                 }
 
@@ -200,6 +232,11 @@ namespace aoc {
         }
     }
 
+    std::string_view requested_engine() noexcept
+    {
+        return engine_name();
+    }
+
     int solve(int argc, char** argv, const solver_interface& solver) noexcept
     {
         try {
@@ -10,44 +10,106 @@
 #include <limits>
 #include <cassert>
 #include <memory>
+#include <tuple>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cctype>
+#include <optional>
+
+#include <ddr/data/flat_hash.h>
 
 namespace {
     using namespace aoc;
 
     constexpr std::size_t YEAR = 2018;
     constexpr std::size_t  DAY = 1;
-    using input_t = std::vector<std::intmax_t>;
 
+    // Consumes the changes one at a time, so the list of changes never has to be kept: besides the
+    // current frequency, it only keeps the frequencies of the first pass, in order, until one of them
+    // repeats. Memory is thus bounded by the number of distinct frequencies.
+    class frequency_tracker {
+    public:
+        void push(std::intmax_t change) {
+            if (!repetition_) {
+                if (seen_.insert(frequency_).second) first_pass_.push_back(frequency_);
+                else {
+                    // decided, the first pass is no longer needed
+                    repetition_ = frequency_;
+                    seen_ = {};
+                    first_pass_ = {};
+                }
+            }
+            frequency_ += change;
+            ++size_;
+        }
+
+        std::size_t size() const noexcept { return size_; }
+        // frequency after all the changes pushed so far
+        std::intmax_t frequency() const noexcept { return frequency_; }
+        // first frequency reached twice during the first pass, if any
+        const std::optional<std::intmax_t>& repetition() const noexcept { return repetition_; }
+        // frequencies f[0], ..., f[N-1] of the first pass (empty if it has a repetition)
+        const std::vector<std::intmax_t>& first_pass() const noexcept { return first_pass_; }
+
+    private:
+        std::size_t size_ = 0;
+        std::intmax_t frequency_ = 0;
+        std::optional<std::intmax_t> repetition_;
+        ddr::data::flat_hash_set<std::intmax_t> seen_;
+        std::vector<std::intmax_t> first_pass_;
+    };
+
+    using input_t = frequency_tracker;
+
+    // the input is read in chunks and the changes are pushed as they are parsed
     input_t parse_input(std::istream& is) {
         input_t in;
-        using istream_it = std::istream_iterator<std::intmax_t>;
-        std::copy(istream_it(is), istream_it(), std::back_inserter(in));
+        auto push = [&in](std::string_view token) {
+            if (token.size() > 1 && token[0] == '+' && token[1] != '-') token.remove_prefix(1);
+            std::intmax_t change;
+            auto[last, ec] = std::from_chars(token.data(), token.data() + token.size(), change);
+            if (ec != std::errc{} || last != token.data() + token.size()) throw parse_exception{};
+            in.push(change);
+        };
+        auto is_space = [](char ch) { return std::isspace(static_cast<unsigned char>(ch)) != 0; };
+
+        std::vector<char> buffer(std::size_t(1) << 16);
+        std::string carry; // token split between two chunks
+        while (is) {
+            is.read(buffer.data(), std::streamsize(buffer.size()));
+            std::string_view chunk{ buffer.data(), std::size_t(is.gcount()) };
+            for (std::size_t i = 0; i < chunk.size();) {
+                if (is_space(chunk[i])) {
+                    if (!carry.empty()) { push(carry); carry.clear(); }
+                    ++i;
+                    continue;
+                }
+                std::size_t j = i;
+                while (j < chunk.size() && !is_space(chunk[j])) ++j;
+                if (j == chunk.size()) carry.append(chunk.substr(i));
+                else if (carry.empty()) push(chunk.substr(i, j - i));
+                else {
+                    carry.append(chunk.substr(i, j - i));
+                    push(carry);
+                    carry.clear();
+                }
+                i = j;
+            }
+        }
+        if (!carry.empty()) push(carry);
         if (!is.eof()) throw parse_exception{};
-        if (in.empty()) throw parse_exception{};
+        if (in.size() == 0) throw parse_exception{};
 
         return in;
     }
 
     auto resultA(const input_t& in) noexcept -> std::intmax_t
     {
-        return std::accumulate(std::begin(in), std::end(in), (std::intmax_t)0);
-    }
-
-    std::optional<std::intmax_t> first_repetition(const input_t& fs) noexcept
-    {
-        // can be made more efficient (n log n)
-        for (std::size_t i = 0; i+1 < fs.size(); ++i) {
-            for (std::size_t j = i+1; j < fs.size(); ++j)
-            {
-                if (fs[i] == fs[j]) return fs[i];
-            }
-        }
-        return std::nullopt;
+        return in.frequency();
     }
 
-    // TODO: in order to avoid quadratic cost, use modulus d as two possible
-    // coincidence will have exactly two
-    auto resultB(const input_t& input) noexcept -> std::optional<std::intmax_t>
+    auto resultB(const input_t& in) noexcept -> std::optional<std::intmax_t>
     {
         // given frequencies f_i = input[0] + ... + input[i], i < N-1
         // we are looking for:
@@ -78,46 +140,55 @@ namespace {
         // before f[i_1] + kd, if i_0 < i_1.
         //
         // The case where d == 0 is simpler in the sense that f[0] is exactly f[N], thus we should only
-        // check if there is any f[i] = f[j], i < j, and the result will be the one with the smallest i.
-        using std::begin, std::end;
-
-        std::intmax_t d = std::accumulate(begin(input), end(input), (std::intmax_t)0);
-
-        std::vector<std::intmax_t> fs;
-        fs.reserve(input.size());
-        fs.push_back(0);
-
-        std::transform(begin(input), std::prev(end(input)), std::back_inserter(fs), [s = std::intmax_t(0)](auto i) mutable {
-            return (s+=i);
-        });
+        // check if there is any f[i] = f[j], i < j, and the result will be the one reached twice first.
+        // The same holds when some f[i] = f[j], i != j, whatever d is: that is k = 0, found during the
+        // first pass over the changes.
+        //
+        // Otherwise, f[i] + kd = f[j] requires both to be congruent modulo d. Bucketing the frequencies
+        // by residue and sorting each bucket by value (negating them if d < 0), the smallest k for a
+        // given i is reached by the next frequency of its bucket. This takes O(n log n) instead of
+        // checking all the pairs.
+        if (in.repetition()) return in.repetition();
 
+        const auto& fs = in.first_pass();
+        std::intmax_t d = in.frequency();
         assert(!fs.empty());
-        if (d == 0) {
-            return first_repetition(fs).value_or(fs[0]);
-        }
+        if (d == 0) return fs[0];
 
-        std::intmax_t result = 0;
-        std::uintmax_t not_found = std::numeric_limits<std::uintmax_t>::max();
-        std::uintmax_t k = not_found;
+        // (residue, value, index) sorted, with d > 0
+        struct entry_t {
+            std::intmax_t residue;
+            std::intmax_t value;
+            std::size_t index;
+        };
+        std::intmax_t sign = d < 0 ? -1 : 1;
+        d *= sign;
+        std::vector<entry_t> entries;
+        entries.reserve(fs.size());
         for (std::size_t i = 0; i < fs.size(); ++i) {
-            for (std::size_t j = 0; j < fs.size(); ++j) {
-                // fs[i] + k*d = fs[j]
-                // k*d = fs[j] - fs[i]
-                auto diff = fs[j] - fs[i];
-                auto remquo = std::div(diff, d);
-                // help branch predictor using & instead of &&
-                // the condition checks the following:
-                //   if i is equal to j, then we should skip this iteration
-                //   only when the remainder is 0 f[j] can be reached from f[i]
-                //   we must ensure k >= 0 (k=quotient)
-                //   finally we should only get the value if obtained k is less than previously obtained k, sorting by i is done implicitly
-                if ((i != j) & (remquo.rem == 0) & (remquo.quot >= 0) & (std::uintmax_t(remquo.quot) < k)) {
-                    result = fs[j];
-                    k = remquo.quot;
-                }
+            std::intmax_t value = sign * fs[i];
+            std::intmax_t residue = value % d;
+            entries.push_back({ residue < 0 ? residue + d : residue, value, i });
+        }
+        std::sort(entries.begin(), entries.end(), [](const entry_t& lhs, const entry_t& rhs) {
+            return std::tie(lhs.residue, lhs.value) < std::tie(rhs.residue, rhs.value);
+        });
+
+        std::optional<std::intmax_t> result;
+        std::intmax_t k = 0;
+        std::size_t i = 0;
+        for (std::size_t e = 0; e + 1 < entries.size(); ++e) {
+            const auto& from = entries[e];
+            const auto& to = entries[e + 1];
+            if (from.residue != to.residue) continue;
+            std::intmax_t ek = (to.value - from.value) / d;
+            if (!result || ek < k || (ek == k && from.index < i)) {
+                result = fs[to.index];
+                k = ek;
+                i = from.index;
             }
         }
-        return k != not_found ? std::optional(result) : std::nullopt;
+        return result;
     }
 }
 
@@ -14,58 +14,113 @@
 #include <array>
 #include <string_view>
 #include <string>
+#include <utility>
+
+#include <ddr/data/fixed_width_table.h>
+#include <ddr/data/flat_hash.h>
+#include <ddr/memory/object_pool.h>
+#include <ddr/parallel/algorithm.h>
 
 namespace {
     using namespace aoc;
     constexpr std::size_t YEAR = 2018;
     constexpr std::size_t  DAY = 2;
-    using input_t = std::vector<std::string>;
+    using ids_t = ddr::data::fixed_width_table;
 
-    input_t parse_input(std::istream& is)
+    ids_t parse_ids(std::istream& is)
     {
-        input_t in;
-        using istream_it = std::istream_iterator<std::string>;
-        std::copy(istream_it(is), istream_it(), std::back_inserter(in));
-        if (in.empty() || !is.eof()) throw parse_exception{};
-
-        // guarantee all boxes ID are of same size and with characters in 'a'-'z' range (lowercase)
-        std::size_t size_id = in[0].size();
-        for (const auto& s : in) {
-            if (s.size() != size_id || s.end() != std::find_if(s.begin(), s.end(), [](char ch) { return ch < 'a' || ch > 'z'; }))
+        ids_t in;
+        std::string id;
+        while (is >> id) {
+            // all boxes ID are of same size and with characters in 'a'-'z' range (lowercase)
+            if (in.empty()) in = ids_t{ id.size() };
+            if (id.size() != in.width() || id.end() != std::find_if(id.begin(), id.end(), [](char ch) { return ch < 'a' || ch > 'z'; }))
                 throw parse_exception{};
+            in.push_back(id);
         }
+        if (in.empty() || !is.eof()) throw parse_exception{};
         return in;
     }
 
-    std::size_t resultA(const input_t& in) noexcept
+    // Two engines for the second part, deletions by default:
+    //  - deletions: a hash set of the IDs without the character at each position, O(n L)
+    //  - trie: a trie of the previous IDs, searched allowing one mismatch
+    enum class engine_t {
+        deletions,
+        trie
+    };
+
+    constexpr std::array<std::pair<std::string_view, engine_t>, 2> engine_names = { {
+        { "deletions", engine_t::deletions },
+        { "trie", engine_t::trie },
+    } };
+
+    struct input_t {
+        ids_t ids;
+        engine_t engine;
+    };
+
+    input_t parse_input(std::istream& is)
     {
-        std::size_t exactly_2 = 0;
-        std::size_t exactly_3 = 0;
-        for (std::string s : in) {
-            std::sort(s.begin(), s.end());
-
-            bool has_two = false;
-            bool has_three = false;
-            auto i = s.begin();
-            decltype(i) j;
-            while (i != s.end()) {
-                auto j = std::adjacent_find(i, s.end(), [](const auto& lhs, const auto& rhs) { return lhs != rhs; });
-                std::advance(j, j != s.end());
-                auto ncount = std::distance(i, j);
-                if (ncount == 2) has_two = true;
-                else if (ncount == 3) has_three = true;
-                i = j;
+        return { parse_ids(is), select_engine(engine_names) };
+    }
+
+    // Letter histogram of an ID, one byte per letter (IDs must be shorter than 256) packed in four
+    // 64-bit words, so that looking for letters appearing exactly n times tests 8 letters at once.
+    struct letter_counts_t {
+        static constexpr std::uint64_t lsbs = 0x0101010101010101ULL;
+        static constexpr std::uint64_t msbs = 0x8080808080808080ULL;
+
+        explicit letter_counts_t(std::string_view id) noexcept {
+            std::array<std::uint8_t, 32> counts{};
+            for (char ch : id) ++counts[std::size_t(ch - 'a')];
+            for (std::size_t w = 0; w < words.size(); ++w) {
+                for (std::size_t b = 0; b < 8; ++b) words[w] |= std::uint64_t(counts[8 * w + b]) << (8 * b);
+            }
+        }
+
+        // true if some letter appears exactly n times, n > 0 (unused bytes are zero)
+        bool has(std::uint8_t n) const noexcept {
+            std::uint64_t found = 0;
+            for (auto word : words) {
+                // zero byte detection, exact as to whether some byte is zero
+                std::uint64_t x = word ^ (lsbs * n);
+                found |= (x - lsbs) & ~x & msbs;
             }
-            exactly_2 += std::size_t(has_two);
-            exactly_3 += std::size_t(has_three);
+            return found != 0;
         }
 
+        std::array<std::uint64_t, 4> words{};
+    };
+
+    // IDs per block when counting in parallel, smaller inputs are counted by the calling thread
+    constexpr std::size_t ids_per_block = std::size_t(1) << 14;
+
+    std::size_t resultA(const input_t& input) noexcept
+    {
+        const auto& in = input.ids;
+        using counts_t = std::pair<std::size_t, std::size_t>;
+        auto count = [&in](std::size_t i) -> counts_t {
+            if (in.width() < 256) {
+                letter_counts_t counts{ in[i] };
+                return { counts.has(2), counts.has(3) };
+            }
+            std::array<std::size_t, 26> counts{};
+            for (char ch : in[i]) ++counts[std::size_t(ch - 'a')];
+            auto has = [&counts](std::size_t n) { return std::find(counts.begin(), counts.end(), n) != counts.end(); };
+            return { has(2), has(3) };
+        };
+        auto sum = [](const counts_t& lhs, const counts_t& rhs) -> counts_t {
+            return { lhs.first + rhs.first, lhs.second + rhs.second };
+        };
+        auto[exactly_2, exactly_3] = ddr::parallel::parallel_reduce(0, in.size(), counts_t{ 0, 0 }, count, sum, ids_per_block);
         return exactly_2 * exactly_3;
     }
 
     struct trie_t {
+        // nodes are owned by the pool of the trie
         struct node_t {
-            std::array<std::unique_ptr<node_t>, 26> children;
+            std::array<node_t*, 26> children{};
         };
 
         static constexpr char idx(char ch) noexcept
@@ -80,66 +135,142 @@ namespace {
             for (std::size_t i = 0; i < str.size(); ++i) {
                 char ch = idx(str[i]);
                 assert(ch >= 0 && ch < 26);
-                if (node->children[ch] != nullptr) node = node->children[ch].get();
+                if (node->children[ch] != nullptr) node = node->children[ch];
                 else {
                     // insert remaining nodes
                     do {
                         ch = idx(str[i]);
-                        node->children[ch] = std::make_unique<node_t>();
-                        node = node->children[ch].get();
+                        node->children[ch] = pool.create();
+                        node = node->children[ch];
                     } while (++i < str.size());
                 }
             }
         }
 
-        friend std::optional<std::string> find_similar(const node_t* node, std::string_view str, std::size_t dissimilarity) noexcept {
-            std::string path;
-            path.reserve(str.size());
-
-            for (std::size_t i = 0; i < str.size(); ++i) {
-                char ch = str[i];
-                auto* next = node->children[idx(ch)].get();
-                if (next != nullptr) {
-                    path += ch;
-                    node = next;
-                    continue;
-                }
-                if (dissimilarity == 0) return std::nullopt;
+        // true if the trie holds str below node
+        static bool contains(const node_t* node, std::string_view str) noexcept
+        {
+            for (std::size_t i = 0; node != nullptr && i < str.size(); ++i) node = node->children[idx(str[i])];
+            return node != nullptr;
+        }
 
-                for (const auto& child : node->children) {
-                    if (child == nullptr) continue;
-                    auto result = find_similar(child.get(), str.substr(i+1), dissimilarity-1);
-                    if (result) return path + result.value();
+        // str without the character at the first position where some ID of the trie differs from it
+        // by exactly that character, as the deletions engine picks it
+        std::optional<std::string> find(std::string_view str) const noexcept
+        {
+            const node_t* node = &root;
+            for (std::size_t i = 0; node != nullptr && i < str.size(); ++i) {
+                auto ch = idx(str[i]);
+                auto rest = str.substr(i + 1);
+                for (char other = 0; other < 26; ++other) {
+                    if (other == ch || !contains(node->children[other], rest)) continue;
+                    std::string common{ str.substr(0, i) };
+                    common += rest;
+                    return common;
                 }
-                break;
+                node = node->children[ch];
             }
+            return std::nullopt;
+        }
+
+        ddr::memory::object_pool<node_t> pool;
+        node_t root;
+    };
 
-            if (dissimilarity == 0) return path;
+    // IDs with the character at position pos deleted: hashed in O(1) from the polynomial hash of the
+    // whole ID, h = sum(id[k] * base^(width-1-k)), by removing the term of pos.
+    struct deletions_t {
+        static constexpr std::uint64_t base = 131;
 
-            return std::nullopt;
+        explicit deletions_t(const ids_t& ids) : in(&ids), powers(ids.width(), 1), hashes(ids.size(), 0) {
+            for (std::size_t k = 1; k < powers.size(); ++k) powers[k] = powers[k - 1] * base;
+            for (std::size_t i = 0; i < ids.size(); ++i) {
+                for (char ch : ids[i]) hashes[i] = hashes[i] * base + std::uint64_t(std::uint8_t(ch));
+            }
         }
 
-        std::optional<std::string> find(std::string_view str) const noexcept
-        {
-            return find_similar(&root, str, 1);
+        std::size_t hash(std::size_t i) const noexcept {
+            auto h = hashes[i] - std::uint64_t(std::uint8_t((*in)[i][pos])) * powers[in->width() - 1 - pos];
+            return ddr::data::flat_hash<std::uint64_t>{}(h);
+        }
+        bool equal(std::size_t i, std::size_t j) const noexcept {
+            auto lhs = (*in)[i];
+            auto rhs = (*in)[j];
+            return lhs.substr(0, pos) == rhs.substr(0, pos) && lhs.substr(pos + 1) == rhs.substr(pos + 1);
         }
 
-        node_t root;
+        struct hasher {
+            const deletions_t* d;
+            std::size_t operator()(std::size_t i) const noexcept { return d->hash(i); }
+        };
+        struct key_equal {
+            const deletions_t* d;
+            bool operator()(std::size_t i, std::size_t j) const noexcept { return d->equal(i, j); }
+        };
+
+        const ids_t* in;
+        std::vector<std::uint64_t> powers;
+        std::vector<std::uint64_t> hashes;
+        std::size_t pos = 0;
     };
 
-    std::optional<std::string> resultB(const input_t& in) noexcept
+    // Two IDs differ by exactly one character, at position pos, iff they are equal once that character
+    // is deleted from both (and they are not the same ID). Each position is checked with a hash set of
+    // the indices of the IDs, compared without that character, which takes O(n L) overall and no
+    // allocation per ID. The answer is the ID appearing first with a match among the previous ones,
+    // matching at the first position.
+    std::optional<std::string> find_similar_deletions(const ids_t& in)
+    {
+        deletions_t deletions{ in };
+        using set_t = ddr::data::flat_hash_set<std::size_t, deletions_t::hasher, deletions_t::key_equal>;
+        set_t seen{ in.size(), deletions_t::hasher{ &deletions }, deletions_t::key_equal{ &deletions } };
+
+        std::optional<std::size_t> found, found_pos;
+        for (auto& pos = deletions.pos; pos < in.width(); ++pos) {
+            seen.clear();
+            // later positions only matter for IDs before the one found
+            std::size_t last = found.value_or(in.size());
+            for (std::size_t i = 0; i < last; ++i) {
+                auto[it, inserted] = seen.insert(i);
+                // equal but for pos, they are a pair unless they are the same ID
+                if (!inserted && in.hamming_distance(*it, i, 1) == 1) {
+                    found = i;
+                    found_pos = pos;
+                    break;
+                }
+            }
+        }
+        if (!found) return std::nullopt;
+
+        auto id = in[*found];
+        std::string common{ id.substr(0, *found_pos) };
+        common += id.substr(*found_pos + 1);
+        return common;
+    }
+
+    // The trie grows its pool on demand: near duplicates share most of their nodes.
+    std::optional<std::string> find_similar_trie(const ids_t& in)
     {
         trie_t trie;
         assert(!in.empty());
         trie.insert(in[0]);
         for (std::size_t i = 1; i < in.size(); ++i) {
-            const auto& str = in[i];
+            auto str = in[i];
             auto result = trie.find(str);
             if (result) return result;
             trie.insert(str);
         }
         return std::nullopt;
     }
+
+    std::optional<std::string> resultB(const input_t& in) noexcept
+    {
+        switch (in.engine) {
+            default: assert(false);
+            case engine_t::deletions: return find_similar_deletions(in.ids);
+            case engine_t::trie: return find_similar_trie(in.ids);
+        }
+    }
 }
 
 namespace aoc {
@@ -1,4 +1,5 @@
 #include "aoc/solver.h"
+#include "aoc/part_cache.h"
 
 #include <iostream>
 #include <cstddef>
@@ -19,10 +20,14 @@
 #include <cstdlib>
 #include <tuple>
 #include <regex>
+#include <functional>
+#include <optional>
 
 #include <ddr/math/vector.h>
-#include <ddr/math/grid.h>
 #include <ddr/math/hyperbox.h>
+#include <ddr/math/grid.h>
+#include <ddr/math/prefix_sum.h>
+#include <ddr/parallel/algorithm.h>
 
 namespace {
     using namespace aoc;
@@ -31,12 +36,11 @@ namespace {
 
     using ivec2 = ddr::math::ivec2;
     using rect_t = std::tuple<std::size_t, ddr::math::rect>;
-    using input_t = std::vector<rect_t>;
-    template<typename T> using board_t = ddr::math::grid2<T>;
+    using claims_t = std::vector<rect_t>;
 
-    input_t parse_input(std::istream& is)
+    claims_t parse_claims(std::istream& is)
     {
-        input_t in;
+        claims_t in;
 
         std::regex re{ R"re(#(\d+) @ (\d+),(\d+): (\d+)x(\d+))re" };
         std::string line;
@@ -56,56 +60,168 @@ namespace {
         return in;
     }
 
-    std::size_t resultA(const input_t& in) noexcept
+    // Three engines:
+    //  - dense: claims are added to a difference array over the bounding box of the claims in O(1) each
+    //    and materialized in one pass, which beats the sweeps for dense inputs but costs O(area).
+    //  - banded: the bounding box is split in horizontal bands accumulated in parallel, each one with
+    //    the claims crossing it (clipped), into saturating one byte counters (0, 1, many). Counts and
+    //    claims are then checked in parallel too. It costs O(claimed area) but scales with threads.
+    //  - sweep: sweeps along x over the y coordinates of the claims (compressed), O(n log n) whatever
+    //    the size of the fabric, see ddr::math::covered_volume and ddr::math::non_overlapping.
+    // By default, fabrics whose bounding box has at most dense_max_area square inches use the banded
+    // engine if there are several threads and the dense one otherwise. Any of them can be requested
+    // with --engine (automatic, dense, banded or sweep).
+    enum class engine_t {
+        automatic,
+        dense,
+        banded,
+        sweep
+    };
+
+    constexpr std::intmax_t dense_max_area = std::intmax_t(1) << 22;
+
+    ddr::math::rect bounding_box(const claims_t& in) noexcept
     {
-        board_t<std::size_t> board;
+        ddr::math::rect bbox{};
+        for (const auto&[id, r] : in) bbox = bounding_box(bbox, r);
+        return bbox;
+    }
 
-        // resize board to hold all rects
-        {
-            ivec2 max;
-            for (const auto&[id, r] : in) {
-                max.x = std::max(max.x, r.start.x + r.size.x);
-                max.y = std::max(max.y, r.start.y + r.size.y);
-            }
-            board.resize(max);
-        }
+    constexpr std::array<std::pair<std::string_view, engine_t>, 4> engine_names = { {
+        { "automatic", engine_t::automatic },
+        { "dense", engine_t::dense },
+        { "banded", engine_t::banded },
+        { "sweep", engine_t::sweep },
+    } };
 
-        for (const auto&[id, r] : in)
-            for (const auto& idx : r)
-                ++board[idx];
+    engine_t resolve_engine(const claims_t& in, engine_t engine) noexcept
+    {
+        if (engine != engine_t::automatic) return engine;
+        if (bounding_box(in).volume() > dense_max_area) return engine_t::sweep;
+        return ddr::parallel::default_pool().concurrency() > 1 ? engine_t::banded : engine_t::dense;
+    }
+
+    // layout of the board of the dense engine
+    using board_layout_t = ddr::math::row_major_layout; // or tiled_layout<>, morton_layout
+
+    // number of claims covering each square inch of the bounding box of the claims
+    struct dense_board_t {
+        ivec2 origin;
+        ddr::math::grid2<std::int32_t, board_layout_t> counts;
+    };
+
+    std::optional<dense_board_t> dense_board(const claims_t& in)
+    {
+        auto bbox = bounding_box(in);
+        if (bbox.empty()) return std::nullopt;
 
-        return std::count_if(board.begin(), board.end(), [](auto n) { return n > 1; });
+        ddr::math::difference2<std::int32_t> diff{ bbox.size };
+        for (const auto&[id, r] : in) diff.add({ r.start - bbox.start, r.size }, 1);
+        return dense_board_t{ bbox.start, diff.template materialize<std::int32_t, board_layout_t>() };
     }
 
-    std::optional<std::size_t> resultB(const input_t& in) noexcept
+    // claims covering each square inch of the bounding box of the claims: 0, 1 or 2 (many)
+    struct banded_board_t {
+        ivec2 origin;
+        ddr::math::grid2<std::uint8_t> counts;
+    };
+
+    std::optional<banded_board_t> banded_board(const claims_t& in)
     {
-        board_t<std::size_t> board;
+        auto bbox = bounding_box(in);
+        if (bbox.empty()) return std::nullopt;
 
-        // resize board to hold all rects
-        {
-            ivec2 max;
-            for (const auto& [id, r] : in) {
-                max.x = std::max(max.x, r.start.x + r.size.x);
-                max.y = std::max(max.y, r.start.y + r.size.y);
+        banded_board_t board{ bbox.start, ddr::math::grid2<std::uint8_t>{ bbox.size } };
+        auto counts = board.counts.view();
+        ddr::parallel::parallel_for_blocks(0, std::size_t(bbox.size.y), [&](std::size_t first, std::size_t last) {
+            auto band = ddr::math::rect{ { bbox.start.x, bbox.start.y + std::intmax_t(first) }, { bbox.size.x, std::intmax_t(last - first) } };
+            for (const auto&[id, r] : in) {
+                auto clipped = intersection(r, band);
+                if (clipped.empty()) continue;
+                auto start = clipped.start - bbox.start;
+                for (auto y = start.y; y < start.y + clipped.size.y; ++y) {
+                    std::uint8_t* row = &counts(start.x, y);
+                    for (std::intmax_t x = 0; x < clipped.size.x; ++x) row[x] = std::uint8_t(row[x] + (row[x] < 2));
+                }
             }
-            board.resize(max);
-        }
+        });
+        return board;
+    }
+
+    // The claims and the engine selected. Its board, if any, is built by the first part.
+    struct input_t {
+        claims_t claims;
+        engine_t engine;
+        part_cache<std::optional<dense_board_t>> dense;
+        part_cache<std::optional<banded_board_t>> banded;
+    };
+
+    input_t parse_input(std::istream& is)
+    {
+        input_t in{ parse_claims(is), select_engine(engine_names), {}, {} };
+        in.engine = resolve_engine(in.claims, in.engine);
+        return in;
+    }
 
-        for (const auto& [id, r] : in)
-            for (const auto& idx : r)
-                ++board[idx];
+    std::size_t resultA(const input_t& input) noexcept
+    {
+        const auto& in = input.claims;
+        if (input.engine == engine_t::banded) {
+            const auto& board = input.banded.get([&in]() { return banded_board(in); });
+            if (!board) return 0;
+            auto counts = board->counts.view();
+            return ddr::parallel::parallel_reduce(0, std::size_t(counts.size(1)), std::size_t(0), [&counts](std::size_t y) {
+                auto row = counts.row(std::intmax_t(y));
+                return std::size_t(std::count(row.begin(), row.end(), std::uint8_t(2)));
+            }, std::plus{});
+        }
+        if (input.engine == engine_t::dense) {
+            const auto& board = input.dense.get([&in]() { return dense_board(in); });
+            if (!board) return 0;
+            return std::size_t(std::count_if(board->counts.begin(), board->counts.end(), [](std::int32_t c) { return c >= 2; }));
+        }
+        auto area = ddr::math::covered_volume(in.begin(), in.end(), 2, [](const rect_t& claim) -> const auto& { return std::get<1>(claim); });
+        return std::size_t(area);
+    }
 
-        for (const auto& [id, r] : in) {
-            bool found = true;
-            for (const auto& idx : r) {
-                if (board[idx] != 1) {
-                    found = false;
-                    break;
+    std::optional<std::size_t> resultB(const input_t& input) noexcept
+    {
+        const auto& in = input.claims;
+        // without a board all the claims are empty, thus none overlaps another
+        auto first_claim = [&in]() { return in.empty() ? std::nullopt : std::optional{ std::get<0>(in.front()) }; };
+        if (input.engine == engine_t::banded) {
+            const auto& board = input.banded.get([&in]() { return banded_board(in); });
+            if (!board) return first_claim();
+            // a claim overlaps no other one iff each of its square inches is covered once,
+            // the first such claim is kept
+            auto counts = board->counts.view();
+            auto isolated = [&](std::size_t i) {
+                const auto& r = std::get<1>(in[i]);
+                if (r.empty()) return i;
+                auto start = r.start - board->origin;
+                for (auto y = start.y; y < start.y + r.size.y; ++y) {
+                    const std::uint8_t* row = &counts(start.x, y);
+                    if (!std::all_of(row, row + r.size.x, [](std::uint8_t c) { return c == 1; })) return in.size();
                 }
+                return i;
+            };
+            auto first = ddr::parallel::parallel_reduce(0, in.size(), in.size(), isolated, [](std::size_t lhs, std::size_t rhs) { return std::min(lhs, rhs); });
+            if (first == in.size()) return std::nullopt;
+            return std::get<0>(in[first]);
+        }
+        if (input.engine == engine_t::dense) {
+            const auto& board = input.dense.get([&in]() { return dense_board(in); });
+            if (!board) return first_claim();
+            // a claim overlaps no other one iff each of its square inches is covered once
+            ddr::math::prefix_sum2<std::intmax_t> sums{ board->counts };
+            for (const auto&[id, r] : in) {
+                if (r.empty() || sums.sum({ r.start - board->origin, r.size }) == r.volume()) return id;
             }
-            if (found) return id;
+            return std::nullopt;
         }
-        return std::nullopt;
+        auto claims = ddr::math::non_overlapping(in.begin(), in.end(), [](const rect_t& claim) -> const auto& { return std::get<1>(claim); });
+        if (claims.empty()) return std::nullopt;
+        return std::get<0>(in[claims.front()]);
     }
 }
 
@@ -1,4 +1,5 @@
 #include "aoc/solver.h"
+#include "aoc/part_cache.h"
 
 #include <iostream>
 #include <cstddef>
@@ -18,9 +19,12 @@
 #include <type_traits>
 #include <cstdlib>
 #include <tuple>
-#include <regex>
+#include <optional>
+#include <charconv>
 
 #include <ddr/porting.h>
+#include <ddr/algorithm/radix_sort.h>
+#include <ddr/data/flat_hash.h>
 
 namespace {
     using namespace aoc;
@@ -48,119 +52,222 @@ namespace {
         std::intmax_t mins_since_epoch_;
     };
 
-    enum class event_t {
+    enum class event_t : std::uint8_t {
         begin,
         sleep,
         awake
     };
 
     using id_t = std::size_t;
-    using record_t = std::tuple<date_t, id_t, event_t>;
-    using input_t = std::vector<record_t>;
 
-    input_t parse_input(std::istream& is)
+    // Events are sorted by a single 64-bit key packing the time and the event type, simultaneous events
+    // going in the order begin, sleep, awake. The guard id is set for all the events once sorted.
+    struct record_t {
+        std::uint64_t key;
+        id_t id;
+
+        date_t date() const noexcept { return date_t{ std::intmax_t(key >> 2) }; }
+        event_t event() const noexcept { return event_t(key & 3); }
+    };
+
+    // removes prefix from the front of str, if it is there
+    bool consume(std::string_view& str, std::string_view prefix) noexcept
     {
-        constexpr std::size_t NO_ID = std::numeric_limits<std::size_t>::max();
-        input_t vec;
-
-        std::regex date_re{ R"re(^\[(\d+)-(\d+)-(\d+) (\d+):(\d+)\] )re" };
-        std::regex fallsleep_re{ R"re(falls asleep)re" };
-        std::regex wakeup_re{ R"re(wakes up)re" };
-        std::regex shift_re{ R"re(Guard #(\d+) begins shift)re" };
-
-        std::string line;
-        while (std::getline(is, line))
-        {
-            if (line.empty()) continue;
-
-            std::smatch date_match;
-            if (!std::regex_search(line, date_match, date_re)) throw parse_exception{ "unexpected line format" };
-
-            auto& [t, id, action] = vec.emplace_back();
-            id = NO_ID;
-
-            int year  = std::stoi(date_match[1].str());
-            int month = std::stoi(date_match[2].str());
-            int day   = std::stoi(date_match[3].str());
-            int hour  = std::stoi(date_match[4].str());
-            int min   = std::stoi(date_match[5].str());
-            t = {year, month, day, hour, min};
-
-            if (std::smatch action_match; std::regex_match( date_match[0].second, line.cend(), action_match, fallsleep_re)) action = event_t::sleep;
-            else if (std::smatch action_match; std::regex_match( date_match[0].second, line.cend(), action_match, wakeup_re)) action = event_t::awake;
-            else if (std::smatch action_match; std::regex_match( date_match[0].second, line.cend(), action_match, shift_re))
-            {
-                id = std::stoi(action_match[1].str());
-                action = event_t::begin;
-            }
+        if (str.substr(0, prefix.size()) != prefix) return false;
+        str.remove_prefix(prefix.size());
+        return true;
+    }
+
+    // removes the unsigned number at the front of str
+    std::optional<std::uintmax_t> consume_number(std::string_view& str) noexcept
+    {
+        std::uintmax_t value = 0;
+        auto[last, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+        if (ec != std::errc{} || last == str.data()) return std::nullopt;
+        str.remove_prefix(std::size_t(last - str.data()));
+        return value;
+    }
+
+    // "[YYYY-MM-DD hh:mm] <action>" where action is "falls asleep", "wakes up" or "Guard #<id> begins shift"
+    record_t parse_record(std::string_view line)
+    {
+        std::array<std::intmax_t, 5> fields{};
+        for (std::size_t i = 0; i < fields.size(); ++i) {
+            constexpr std::array<std::string_view, 5> prefixes = { "[", "-", "-", " ", ":" };
+            auto field = consume(line, prefixes[i]) ? consume_number(line) : std::nullopt;
+            if (!field) throw parse_exception{ "unexpected line format" };
+            fields[i] = std::intmax_t(*field);
         }
+        if (!consume(line, "] ")) throw parse_exception{ "unexpected line format" };
+        auto[year, month, day, hour, min] = fields;
+        auto since_epoch = std::uint64_t(date_t{ year, month, day, hour, min }.since_epoch());
 
+        record_t record{ 0, 0 };
+        event_t e;
+        if (line == "falls asleep") e = event_t::sleep;
+        else if (line == "wakes up") e = event_t::awake;
+        else {
+            auto id = consume(line, "Guard #") ? consume_number(line) : std::nullopt;
+            if (!id || line != " begins shift") throw parse_exception{ "unexpected line format" };
+            e = event_t::begin;
+            record.id = id_t(*id);
+        }
+        record.key = (since_epoch << 2) | std::uint64_t(e);
+        return record;
+    }
+
+    std::vector<record_t> parse_records(std::istream& is)
+    {
+        std::vector<record_t> vec;
+        auto push = [&vec](std::string_view line) {
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            if (!line.empty()) vec.push_back(parse_record(line));
+        };
+
+        // the log is parsed line by line from a fixed buffer
+        std::vector<char> buffer(std::size_t(1) << 16);
+        std::string carry; // line split between two chunks
+        while (is) {
+            is.read(buffer.data(), std::streamsize(buffer.size()));
+            std::string_view chunk{ buffer.data(), std::size_t(is.gcount()) };
+            for (auto eol = chunk.find('\n'); eol != std::string_view::npos; eol = chunk.find('\n')) {
+                if (carry.empty()) push(chunk.substr(0, eol));
+                else {
+                    carry.append(chunk.substr(0, eol));
+                    push(carry);
+                    carry.clear();
+                }
+                chunk.remove_prefix(eol + 1);
+            }
+            carry.append(chunk);
+        }
+        push(carry);
+        if (!is.eof()) throw parse_exception{};
         if (vec.empty()) throw parse_exception{};
 
-        std::sort(vec.begin(), vec.end(), [](const record_t& lhs, const record_t& rhs) { return std::get<date_t>(lhs) < std::get<date_t>(rhs); });
-        if (std::get<event_t>(vec[0]) !=  event_t::begin) throw parse_exception{ "first event is not a guard beginning their shift" };
+        ddr::algorithm::radix_sort(vec.begin(), vec.end(), [](const record_t& r) { return r.key; });
+        if (vec[0].event() != event_t::begin) throw parse_exception{ "first event is not a guard beginning their shift" };
 
-        std::size_t last_id = NO_ID;
-        for (auto&[t, id, e] : vec) {
-            if (e == event_t::begin) last_id = id;
-            else id = last_id;
+        id_t last_id = vec[0].id;
+        for (auto& r : vec) {
+            if (r.event() == event_t::begin) last_id = r.id;
+            else r.id = last_id;
         }
 
         return vec;
     }
 
-    template<bool partA>
-    std::size_t result(input_t in) noexcept
-    {
-        // sort by guard id, preserving time order
-        std::stable_sort(in.begin(), in.end(), [](const auto& lhs, const auto& rhs) { return std::get<id_t>(lhs) < std::get<id_t>(rhs); });
+    struct guard_t {
+        id_t id;
+        // minute it fell asleep at, if sleeping
+        std::optional<std::intmax_t> asleep_since{};
+        // minutes asleep: whole hours asleep plus a difference array over the minutes of the hour
+        std::size_t hours = 0;
+        std::array<std::ptrdiff_t, 61> diff{};
 
-        using guard_info_t = std::tuple<id_t, std::size_t, std::size_t, std::size_t>;
-        std::vector<guard_info_t> guards;
-        for (auto first = in.begin(); first != in.end();)
-        {
-            auto last = std::next(std::adjacent_find(first, std::prev(in.end()), [](const auto& lhs, const auto& rhs){ return std::get<id_t>(lhs) != std::get<id_t>(rhs); }));
-
-            auto&[id, total, best_minute, total_best_minute] = guards.emplace_back();
+        void sleep(std::intmax_t from, std::intmax_t to) noexcept {
+            auto length = std::size_t(to - from);
+            hours += length / 60;
+            auto first = std::size_t(((from % 60) + 60) % 60);
+            auto last = first + length % 60;
+            ++diff[first];
+            if (last <= 60) --diff[last];
+            else {
+                // wraps around the hour
+                --diff[60];
+                ++diff[0];
+                --diff[last - 60];
+            }
+        }
+    };
 
-            id = std::get<id_t>(*first);
+    struct summary_t {
+        // the guard sleeping the most, times its most slept minute
+        std::size_t most_asleep;
+        // the guard sleeping the most at the same minute, times that minute
+        std::size_t most_regular;
+    };
 
-            std::array<std::size_t, 60> totals{};
-            std::optional<date_t> sleeping_since;
-            for (auto event_it = first; event_it != last; ++event_it) {
-                switch (std::get<event_t>(*event_it)) {
+    // Both parts at once: a single pass over the sorted events fills a difference array per guard,
+    // then each guard gets its totals. Ties go to the smallest guard id, and then the earliest minute.
+    summary_t summarize(const std::vector<record_t>& in)
+    {
+        std::vector<guard_t> guards;
+        ddr::data::flat_hash_map<id_t, std::size_t> index;
+        guard_t* guard = nullptr;
+        for (const auto& r : in) {
+            auto t = r.date().since_epoch();
+            switch (r.event()) {
                 default: assert(false);
-                case event_t::begin: break;
-                case event_t::sleep: sleeping_since = sleeping_since.value_or(std::get<date_t>(*event_it)); break;
+                case event_t::begin: {
+                    auto[it, inserted] = index.try_emplace(r.id, guards.size());
+                    if (inserted) guards.push_back(guard_t{ r.id });
+                    guard = &guards[it->second];
+                    break;
+                }
+                case event_t::sleep:
+                    if (!guard->asleep_since) guard->asleep_since = t;
+                    break;
                 case event_t::awake:
-                    if (sleeping_since) {
-                        const date_t& t = std::get<date_t>(*event_it);
-                        assert(t.since_epoch() - sleeping_since->since_epoch() < 60);
-                        for (auto i = sleeping_since->since_epoch(); i < t.since_epoch(); ++i) {
-                            ++totals[i%60];
-                        }
-                        sleeping_since.reset();
+                    if (guard->asleep_since) {
+                        guard->sleep(*guard->asleep_since, t);
+                        guard->asleep_since.reset();
                     }
                     break;
+            }
+        }
+
+        // (total, id, minute) and (count at minute, id, minute) of the best guards
+        using best_t = std::tuple<std::size_t, id_t, std::size_t>;
+        std::optional<best_t> most_asleep, most_regular;
+        auto better = [](const std::optional<best_t>& best, const best_t& candidate) {
+            if (!best) return true;
+            return std::get<0>(candidate) > std::get<0>(*best) || (std::get<0>(candidate) == std::get<0>(*best) && std::get<1>(candidate) < std::get<1>(*best));
+        };
+        for (const auto& g : guards) {
+            std::size_t total = 0, best_minute = 0, best_count = 0;
+            std::ptrdiff_t running = 0;
+            for (std::size_t m = 0; m < 60; ++m) {
+                running += g.diff[m];
+                auto count = g.hours + std::size_t(running);
+                total += count;
+                if (count > best_count) {
+                    best_count = count;
+                    best_minute = m;
                 }
             }
+            if (better(most_asleep, { total, g.id, best_minute })) most_asleep = best_t{ total, g.id, best_minute };
+            if (better(most_regular, { best_count, g.id, best_minute })) most_regular = best_t{ best_count, g.id, best_minute };
+        }
+        assert(most_asleep && most_regular);
+        return { std::get<1>(*most_asleep) * std::get<2>(*most_asleep), std::get<1>(*most_regular) * std::get<2>(*most_regular) };
+    }
 
-            total = std::accumulate(totals.begin(), totals.end(), (std::size_t)0);
-            auto max_bm = std::max_element(totals.begin(), totals.end());
-            best_minute = (std::size_t) std::distance(totals.begin(), max_bm);
-            total_best_minute = *max_bm;
+    // both parts come from the same summary, computed by the first one
+    struct input_t {
+        std::vector<record_t> records;
+        part_cache<summary_t> summary;
+    };
 
-            std::swap(first, last);
-        }
+    input_t parse_input(std::istream& is)
+    {
+        return { parse_records(is), {} };
+    }
 
-        auto max_it = std::max_element(guards.begin(), guards.end(), [](const auto& x, const auto& y){ return std::get<partA ? 1 : 3>(x) < std::get<partA ? 1 : 3>(y); });
-        return std::get<0>(*max_it) * std::get<2>(*max_it);
+    std::size_t resultA(const input_t& in) noexcept
+    {
+        return in.summary.get([&in]() { return summarize(in.records); }).most_asleep;
+    }
+
+    std::size_t resultB(const input_t& in) noexcept
+    {
+        return in.summary.get([&in]() { return summarize(in.records); }).most_regular;
     }
 }
 
 namespace aoc {
     template<>
     auto create_solver<YEAR, DAY>() noexcept -> std::unique_ptr<solver_interface> {
-        return create_solver<YEAR, DAY>(parse_input, result<true>, result<false>);
+        return create_solver<YEAR, DAY>(parse_input, resultA, resultB);
     }
 }
\ No newline at end of file
@@ -7,71 +7,150 @@
 #include <array>
 #include <limits>
 #include <cassert>
+#include <iterator>
+#include <string_view>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+#include <ddr/parallel/algorithm.h>
 
 namespace {
     using namespace aoc;
     constexpr std::size_t YEAR = 2018;
     constexpr std::size_t  DAY = 5;
+    // reduced polymer
     using input_t = std::string;
 
-    input_t parse_input(std::istream& is)
-    {
-        input_t str;
+    // assume ascii, otherwise it should use locale
+    char to_lower(char c) noexcept {
+        assert((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'));
+        return char(c | 0x20);
+    }
+    // units of the same type and opposite polarity only differ in the case bit
+    bool opposite(char a, char b) noexcept {
+        return (a ^ b) == 0x20;
+    }
 
-        is >> str;
-        if (is.fail()) throw parse_exception{};
+    namespace swar {
+        constexpr std::uint64_t lsbs = 0x0101010101010101ULL;
+        constexpr std::uint64_t msbs = 0x8080808080808080ULL;
 
-        // ensure input belongs to a-zA-Z.
-        if (!std::all_of(str.begin(), str.end(), [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); })) {
-            throw parse_exception{};
+        std::uint64_t load(const char* p) noexcept {
+            std::uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            return word;
+        }
+        // true if some byte of word is b
+        bool has_byte(std::uint64_t word, std::uint8_t b) noexcept {
+            std::uint64_t x = word ^ (lsbs * b);
+            return ((x - lsbs) & ~x & msbs) != 0;
         }
-
-        return str;
     }
 
-    // assume ascii, otherwise it should use locale
-    char to_lower(char c) noexcept {
-        assert((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'));
-        return (c < 'a') ? c + 'a' - 'A' : c;
+    // Reacts the polymer str, skipping the units of type removed (lowercase, 0 for none), into out,
+    // used as the stack of the reaction. Returns the size of the reduced polymer, in [out, out + size).
+    // out needs str.size() chars and may be str.data(), the stack never overtakes the input.
+    // Words of 8 units that neither have reacting (or removed) units nor react with the top of the
+    // stack are pushed at once, they are detected with 64-bit arithmetic (SIMD within a register).
+    std::size_t react(std::string_view str, char* out, char removed = 0) noexcept {
+        const char* in = str.data();
+        const std::size_t size = str.size();
+        std::size_t top = 0;
+        for (std::size_t i = 0; i < size;) {
+            if (i + 9 <= size && (top == 0 || !opposite(out[top - 1], in[i]))) {
+                // byte k of pairs is in[i+k] ^ in[i+k+1]
+                std::uint64_t word = swar::load(in + i);
+                std::uint64_t pairs = word ^ swar::load(in + i + 1);
+                if (!swar::has_byte(pairs, 0x20) && (removed == 0 || !swar::has_byte(word | (swar::lsbs * 0x20), std::uint8_t(removed)))) {
+                    std::memmove(out + top, in + i, 8);
+                    top += 8;
+                    i += 8;
+                    continue;
+                }
+            }
+            char c = in[i++];
+            if (to_lower(c) == removed) continue;
+            if (top > 0 && opposite(out[top - 1], c)) --top;
+            else out[top++] = c;
+        }
+        return top;
     }
-    bool opposite(char a, char b) noexcept {
-        return std::abs(a-b) == ('a' - 'A');
+
+    // appends the reduced polymer right to the reduced polymer left, only their seam can react
+    void merge(input_t& left, std::string_view right) {
+        std::size_t i = 0;
+        while (!left.empty() && i < right.size() && opposite(left.back(), right[i])) {
+            left.pop_back();
+            ++i;
+        }
+        left.append(right.substr(i));
     }
 
-    std::string reaction(std::string_view str) noexcept {
-        std::string stack;
-        for (char c : str) {
-            if (stack.empty() || !opposite(stack.back(), c)) {
-                stack.push_back(c);
-            } else { // reaction happened
-                stack.pop_back();
+    // units read and reduced at once, a batch of one chunk per thread is reduced in parallel
+    constexpr std::size_t chunk_size = std::size_t(1) << 20;
+
+    // The polymer (the first word of the input) is reduced while it is read: reduction is associative,
+    // a polymer reduces as the merge of its reduced chunks. Thus memory is bounded by the reduced
+    // polymer plus a batch of chunks, and the input is the reduced polymer, which is all both parts need.
+    // Note that parsing thus does all the work of part A, whose timing only covers taking the size.
+    input_t parse_input(std::istream& is)
+    {
+        auto is_space = [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+        auto is_unit = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+
+        input_t reduced;
+        bool empty = true;
+        bool done = false;
+        std::vector<std::string> batch(ddr::parallel::default_pool().concurrency());
+        std::vector<std::size_t> sizes(batch.size());
+        // as `is >> str` would, the word starts at the first non-space
+        is >> std::ws;
+        while (!done) {
+            std::size_t n = 0;
+            for (; n < batch.size() && !done; ++n) {
+                auto& chunk = batch[n];
+                chunk.resize(chunk_size);
+                is.read(chunk.data(), std::streamsize(chunk.size()));
+                chunk.resize(std::size_t(is.gcount()));
+                auto end = std::find_if(chunk.begin(), chunk.end(), is_space);
+                if (end != chunk.end() || chunk.size() < chunk_size) {
+                    chunk.erase(end, chunk.end());
+                    done = true;
+                }
+                // ensure input belongs to a-zA-Z.
+                if (!std::all_of(chunk.begin(), chunk.end(), is_unit)) throw parse_exception{};
+                empty = empty && chunk.empty();
             }
+            ddr::parallel::parallel_for(0, n, [&](std::size_t i) { sizes[i] = react(batch[i], batch[i].data()); }, 1);
+            for (std::size_t i = 0; i < n; ++i) merge(reduced, std::string_view{ batch[i].data(), sizes[i] });
         }
+        if (empty) throw parse_exception{};
 
-        return stack;
+        return reduced;
     }
 
     std::size_t resultA(const input_t& in) noexcept {
-        return reaction(in).size();
+        // the input is already reduced, see parse_input
+        return in.size();
     }
 
     std::size_t resultB(const input_t& in) noexcept {
-        const auto reacted_in = reaction(in);
+        // removing a unit from the reduced polymer gives the same result as removing it from the input
         std::array<bool, 'z'-'a' + 1> has_unit{};
-        for (auto c : reacted_in) has_unit[to_lower(c) - 'a'] = true;
-
+        for (auto c : in) has_unit[to_lower(c) - 'a'] = true;
 
-        std::size_t min_size = std::numeric_limits<std::size_t>::max();
-        for (std::size_t i = 0; i < has_unit.size(); ++i) {
-            if (has_unit[i]) {
-                std::string filtered;
-                filtered.reserve(reacted_in.size());
-                std::copy_if(reacted_in.begin(), reacted_in.end(), std::back_inserter(filtered), [e = i+'a'](char c) { return to_lower(c) != e; });
-                min_size = std::min(min_size, reaction(filtered).size());
+        // units are removed in parallel, each block of units reusing the same stack
+        std::array<std::size_t, 'z'-'a' + 1> sizes;
+        sizes.fill(std::numeric_limits<std::size_t>::max());
+        ddr::parallel::parallel_for_blocks(0, has_unit.size(), [&](std::size_t first, std::size_t last) {
+            std::string stack(in.size(), '\0');
+            for (std::size_t i = first; i < last; ++i) {
+                if (has_unit[i]) sizes[i] = react(in, stack.data(), char('a' + i));
             }
-        }
+        });
 
-        return min_size;
+        return *std::min_element(sizes.begin(), sizes.end());
     }
 }
 
@@ -9,20 +9,48 @@
 #include <numeric>
 #include <iterator>
 #include <functional>
+#include <limits>
+#include <cstdint>
+#include <array>
+#include <string_view>
+#include <utility>
+#include <optional>
 
 #include <ddr/math/vector.h>
 #include <ddr/math/grid.h>
 #include <ddr/math/hyperbox.h>
+#include <ddr/math/vector_batch.h>
+#include <ddr/algorithm/radix_sort.h>
 
 namespace {
     using namespace aoc;
     constexpr std::size_t YEAR = 2018;
     constexpr std::size_t DAY  = 6;
     using ivec2 = ddr::math::ivec2;
-    using input_t = std::vector<ivec2>;
+    using points_t = std::vector<ivec2>;
+    // layout of the board explored by the breadth-first search
+    using board_layout_t = ddr::math::row_major_layout; // or tiled_layout<>, morton_layout
+
+    // Two engines for the first part, bfs by default:
+    //  - bfs: a breadth-first search from all the points at once, O(W H)
+    //  - batch: the closest point of each cell among all of them with vec2_batch kernels, O(W H N)
+    enum class engine_t {
+        bfs,
+        batch
+    };
 
-    input_t parse_input(std::istream& is) {
-        input_t vec;
+    constexpr std::array<std::pair<std::string_view, engine_t>, 2> engine_names = { {
+        { "bfs", engine_t::bfs },
+        { "batch", engine_t::batch },
+    } };
+
+    struct input_t {
+        points_t points;
+        engine_t engine;
+    };
+
+    points_t parse_points(std::istream& is) {
+        points_t vec;
 
         auto expect = [](std::istream& is, char c)
         {
@@ -49,59 +77,123 @@ namespace {
         return vec;
     }
 
-    std::optional<std::size_t> resultA(input_t in) noexcept {
-        // We need to compute the Voronoi diagram using Manhattan distance.
-        // As our space is discrete, we can brute-force it.
+    input_t parse_input(std::istream& is) {
+        return { parse_points(is), select_engine(engine_names) };
+    }
+
+    // nearest point of each cell, nullopt if there are several
+    using closest_t = ddr::math::grid2<std::optional<std::size_t>>;
+
+    // We need to compute the Voronoi diagram using Manhattan distance.
+    // As our space is discrete, a breadth-first search from all the points at once visits the cells
+    // by increasing distance, which on a grid without obstacles is the Manhattan one. The nearest
+    // points of a cell are those of its neighbours one step closer, so each cell inherits the owner
+    // of those neighbours, or a tie if they disagree (or are tied). O(W H) whatever the number of points.
+    std::optional<closest_t> closest_bfs(const points_t& in, const ivec2& size_board) {
+        using namespace ddr::math;
+
+        // Point indices must fit the owner of the cells, with room for the unvisited and tied marks.
+        struct cell_t {
+            std::uint32_t distance;
+            std::uint32_t owner;
+        };
+        constexpr std::uint32_t unvisited = std::numeric_limits<std::uint32_t>::max();
+        constexpr std::uint32_t tied = unvisited - 1;
+        if (in.size() >= tied) return std::nullopt;
+
+        grid2<cell_t, board_layout_t> cells{ size_board };
+        std::fill(cells.begin(), cells.end(), cell_t{ unvisited, tied });
+
+        std::vector<ivec2> frontier, next;
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            auto& c = cells[in[i]];
+            if (c.distance == unvisited) {
+                c = { 0, std::uint32_t(i) };
+                frontier.push_back(in[i]);
+            } else {
+                c.owner = tied; // repeated point
+            }
+        }
+        const rect board_rect{ ivec2{0,0}, size_board };
+        for (std::uint32_t d = 1; !frontier.empty(); ++d) {
+            for (const auto& p : frontier) {
+                const auto owner = cells[p].owner;
+                for (auto step : { ivec2{1,0}, ivec2{-1,0}, ivec2{0,1}, ivec2{0,-1} }) {
+                    auto q = p + step;
+                    if (!board_rect.contains(q)) continue;
+                    auto& c = cells[q];
+                    if (c.distance == unvisited) {
+                        c = { d, owner };
+                        next.push_back(q);
+                    } else if (c.distance == d && c.owner != owner) {
+                        c.owner = tied;
+                    }
+                }
+            }
+            std::swap(frontier, next);
+            next.clear();
+        }
+
+        closest_t closest_point{ size_board };
+        for (const auto& p : board_rect) {
+            auto owner = cells[p].owner;
+            if (owner != tied) closest_point[p] = owner;
+        }
+        return closest_point;
+    }
+
+    // Closest point of each cell by comparing it with all the points, in 32 bits so that the
+    // kernels process as many lanes as possible. O(W H N).
+    std::optional<closest_t> closest_batch(const points_t& in, const ivec2& size_board) {
+        using namespace ddr::math;
+
+        // indices are computed in 32 bits too
+        if (in.size() >= std::size_t(std::numeric_limits<std::int32_t>::max())) return std::nullopt;
+
+        const i32vec2_batch points{ in.begin(), in.end() };
+        closest_t closest_point{ size_board };
+        for (const auto& p : rect{ ivec2{0,0}, size_board }) {
+            auto closest = argmin_manh(points, i32vec2_batch::value_type{ std::int32_t(p.x), std::int32_t(p.y) });
+            if (closest.unique) closest_point[p] = closest.index;
+        }
+        return closest_point;
+    }
+
+    std::optional<std::size_t> resultA(const input_t& input) noexcept {
         using namespace ddr::math;
 
         // Move to a more appropiate origin.
+        auto in = input.points;
         auto min_point = std::reduce(std::next(in.begin()), in.end(), *in.begin(), [](const auto& lhs, const auto& rhs) { return min(lhs, rhs); });
         std::transform(in.begin(), in.end(), in.begin(), [min_point](const auto& x){ return x - min_point; });
         auto max_point = std::reduce(std::next(in.begin()), in.end(), *in.begin(), [](const auto& lhs, const auto& rhs) { return max(lhs, rhs); });
         auto size_board = max_point + ivec2{1,1};
 
         // Bounding box now is { (0,0), max_point }.
-        grid2<std::optional<std::size_t>> closest_point{ size_board };
+        // Any board big enough to not fit in 32 bits would not fit in memory either.
+        constexpr std::intmax_t max_coord = std::numeric_limits<std::int32_t>::max() / 2;
+        if (max_point.x > max_coord || max_point.y > max_coord) return std::nullopt;
 
-        for (const auto& p : rect{ ivec2{0,0}, size_board }) {
-            auto min_i = std::numeric_limits<std::size_t>::max();
-            auto min_dist = std::numeric_limits<std::intmax_t>::max();
-            bool more_than_once = false;
-            for (std::size_t i = 0; i < in.size(); ++i) {
-                const auto& x = in[i];
-                auto d = manh(x, p);
-                if (d == min_dist) more_than_once = true;
-                else if (d < min_dist) {
-                    more_than_once = false;
-                    min_dist = d;
-                    min_i = i;
-                }
-            }
-            closest_point[p] = more_than_once ? std::nullopt : std::optional{ min_i };
-        }
+        auto closest = input.engine == engine_t::batch ? closest_batch(in, size_board) : closest_bfs(in, size_board);
+        if (!closest) return std::nullopt;
+        const auto& closest_point = *closest;
 
         std::vector<std::optional<std::size_t>> region_size;
         region_size.resize(in.size(), 0);
 
         // Compute the interior regions, assuming all region_size are valid optionals.
-        for (auto p : rect{ivec2{1, 1}, size_board - ivec2{2,2}}) {
-            if (auto idx = closest_point[p]; idx)
-                ++(*region_size[*idx]);
-        }
+        const auto board = closest_point.view();
+        board.subview({ 1, 1 }, { std::max<std::intmax_t>(size_board.x - 2, 0), std::max<std::intmax_t>(size_board.y - 2, 0) })
+            .for_each([&region_size](const auto& idx) {
+                if (idx) ++(*region_size[*idx]);
+            });
 
         // Any point whose region include a point in the boundary will
         // have an infinite region, discard those.
-        for (std::intmax_t x = 0; x < size_board.x; ++x) {
-            auto i = closest_point[{x, 0}];
-            if (i) region_size[*i] = std::nullopt;
-            auto j = closest_point[{x, max_point.y}];
-            if (j) region_size[*j] = std::nullopt;
-        }
-        for (std::intmax_t y = 0; y < size_board.y; ++y) {
-            auto i = closest_point[{0, y}];
-            if (i) region_size[*i] = std::nullopt;
-            auto j = closest_point[{max_point.x, y}];
-            if (j) region_size[*j] = std::nullopt;
+        for (const auto& border : board.borders()) {
+            border.for_each([&region_size](const auto& idx) {
+                if (idx) region_size[*idx] = std::nullopt;
+            });
         }
 
         std::size_t result = 0;
@@ -222,7 +314,7 @@ namespace {
         std::intmax_t origin_;
     };
 
-    std::size_t param_resultB(const input_t& in, std::size_t max_dist) noexcept {
+    std::size_t param_resultB(const points_t& in, std::size_t max_dist) noexcept {
         // This problem can be thought in terms of the gradient of the sum of the distances.
         // In particular, given points P = { in[0], ..., in[N-1] }, there is a squared
         // region that leaves half the points above and half the points below, and
@@ -243,8 +335,9 @@ namespace {
         y_values.reserve(in.size());
         std::transform(in.begin(), in.end(), std::back_inserter(x_values), [](const auto& p) { return p.x; });
         std::transform(in.begin(), in.end(), std::back_inserter(y_values), [](const auto& p) { return p.y; });
-        std::sort(x_values.begin(), x_values.end());
-        std::sort(y_values.begin(), y_values.end());
+        ddr::algorithm::radix_sorter<std::intmax_t> sorter;
+        sorter(x_values.begin(), x_values.end());
+        sorter(y_values.begin(), y_values.end());
 
         // Find sum of distances curve.
         sum_of_distance_curve x_curve{ x_values, std::intmax_t(max_dist) };
@@ -262,7 +355,7 @@ namespace {
     }
 
     std::size_t resultB(const input_t& in) noexcept {
-        return param_resultB(in, 9999);
+        return param_resultB(in.points, 9999);
     }
 }
 
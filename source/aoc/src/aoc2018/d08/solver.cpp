@@ -11,6 +11,7 @@
 #include <limits>
 #include <type_traits>
 #include <cassert>
+#include <tuple>
 
 #include <ddr/data/tree.h>
 
@@ -19,61 +20,67 @@ namespace {
     constexpr std::size_t YEAR = 2018;
     constexpr std::size_t DAY  = 8;
 
-    using node_t = ddr::data::node_t<std::vector<std::intmax_t>>;
-    using input_t = node_t;
+    using tree_t = ddr::data::flat_tree<std::intmax_t>;
+    using input_t = tree_t;
 
     input_t parse_input(std::istream& is)
     {
-        input_t root;
+        input_t tree;
 
-        auto read_tree = [&is](node_t& node) -> void {
-            auto impl = [&is](const auto& self, node_t& node) -> void {
-                std::size_t num_children, num_data;
-                if (!(is >> num_children >> num_data)) throw parse_exception{};
-                node.children.resize(num_children);
-                for (node_t& child : node.children) self(self, child);
-                std::copy_n(std::istream_iterator<std::intmax_t>(is), num_data, std::back_inserter(*node));
-                if (is.fail()) throw parse_exception{};
-            };
-            impl(impl, node);
+        // stack of (node, remaining children, number of metadata entries)
+        std::vector<std::tuple<tree_t::node_id, std::size_t, std::size_t>> stack;
+        auto open = [&is, &tree, &stack]() {
+            std::size_t num_children, num_data;
+            if (!(is >> num_children >> num_data)) throw parse_exception{};
+            stack.emplace_back(tree.open_node(num_children), num_children, num_data);
         };
-        read_tree(root);
 
-        return root;
+        open();
+        while (!stack.empty()) {
+            auto& [node, remaining, num_data] = stack.back();
+            if (remaining > 0) {
+                --remaining;
+                open();
+                continue;
+            }
+            for (std::size_t i = 0; i < num_data; ++i) {
+                std::intmax_t value;
+                if (!(is >> value)) throw parse_exception{};
+                tree.push_value(node, value);
+            }
+            tree.close_node(node);
+            stack.pop_back();
+        }
+
+        return tree;
     }
 
     std::size_t resultA(const input_t& in) noexcept
     {
-        std::vector<const node_t*> nodes;
-        nodes.push_back(&in);
-        std::intmax_t accum = 0;
-        while (!nodes.empty()) {
-            const node_t& node = *nodes.back();
-            nodes.pop_back();
-            accum += std::reduce(node->begin(), node->end());
-            for (const node_t& child : node.children) nodes.push_back(&child);
-        }
-        return std::size_t(accum);
+        // the payloads of all nodes are stored contiguously
+        return std::size_t(std::reduce(in.pool().begin(), in.pool().end(), std::intmax_t(0)));
     }
 
-    std::size_t resultB(const node_t& in) noexcept
+    std::size_t resultB(const input_t& in) noexcept
     {
-        if (in.children.empty()) {
-            auto sum = std::reduce(in->begin(), in->end());
-            return std::size_t(sum);
-        } else {
-            std::vector<std::optional<std::size_t>> cached_values;
-            cached_values.resize(in.children.size());
+        // iterating backwards, the value of all the children is known before visiting the parent
+        std::vector<std::size_t> values(in.size(), 0);
+        std::vector<tree_t::node_id> children;
+        for (auto node = in.size(); node-- > 0;) {
+            auto data = in.data(node);
+            if (in.is_leaf(node)) {
+                values[node] = std::size_t(std::reduce(data.begin(), data.end(), std::intmax_t(0)));
+                continue;
+            }
+            children.assign(in.children(node).begin(), in.children(node).end());
             std::size_t accum = 0;
-            for (auto child : *in)
-            {
-                if (child == 0 || std::size_t(child) > in.children.size()) continue; // invalid child
-                auto& value = cached_values[child-1];
-                if (!value) value = resultB(in.children[child - 1]);
-                accum += *value;
+            for (auto child : data) {
+                if (child == 0 || std::size_t(child) > children.size()) continue; // invalid child
+                accum += values[children[std::size_t(child) - 1]];
             }
-            return accum;
+            values[node] = accum;
         }
+        return values[tree_t::root()];
     }
 }
 
@@ -12,6 +12,10 @@
 #include <memory>
 #include <cassert>
 #include <cctype>
+#include <atomic>
+
+#include <ddr/porting.h>
+#include <ddr/parallel/algorithm.h>
 
 namespace {
     using namespace aoc;
@@ -58,7 +62,9 @@ namespace {
                 auto x = in[std::size_t(in[PC + 1])];
                 auto y = in[std::size_t(in[PC + 2])];
                 auto& to = in[std::size_t(in[PC + 3])];
-                to = in[PC] == OP_SUM ? x + y : x * y;
+                // a program overflowing has no result
+                bool overflow = in[PC] == OP_SUM ? stdx::add_overflow(x, y, to) : stdx::mul_overflow(x, y, to);
+                if (overflow) return std::nullopt;
                 break;
             }
             case OP_HALT: goto end_loop__;
@@ -79,21 +85,29 @@ namespace {
         return run(std::move(in));
     }
 
-    auto resultB(input_t in) noexcept -> std::optional<std::size_t>
+    auto resultB(const input_t& in) noexcept -> std::optional<std::size_t>
     {
         // could be done using symbolic computation,
         // but it should be done in care as opcode could be affected
         // by the input values...
-        for (std::intmax_t noun = 0; noun < 100; ++noun)
-            for (std::intmax_t verb = 0; verb < 100; ++verb) {
-                in[1] = noun;
-                in[2] = verb;
-                auto result = run(in);
-                if (result.value_or(0) == 19690720) {
-                    return std::size_t(100 * noun + verb);
-                }
+        // The first (noun, verb) pair found is the one with smallest 100 * noun + verb, thus the pairs
+        // are checked in parallel blocks keeping the minimum one. Blocks stop at the best pair so far,
+        // so with a single thread the search stops at the first one found, as a sequential loop would.
+        constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+        std::atomic<std::size_t> best{ none };
+        ddr::parallel::parallel_for_blocks(0, 100 * 100, [&in, &best](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last && i < best.load(std::memory_order_relaxed); ++i) {
+                input_t program = in;
+                program[1] = std::intmax_t(i / 100);
+                program[2] = std::intmax_t(i % 100);
+                if (run(std::move(program)).value_or(0) != 19690720) continue;
+                auto current = best.load(std::memory_order_relaxed);
+                while (i < current && !best.compare_exchange_weak(current, i, std::memory_order_relaxed)) {}
+                return;
             }
-        return std::nullopt;
+        }, 100);
+        if (best == none) return std::nullopt;
+        return best.load();
     }
 }
 
@@ -17,6 +17,8 @@
 #include <utility>
 
 #include <ddr/math/vector.h>
+#include <ddr/math/orthogonal_segments.h>
+#include <ddr/algorithm/radix_sort.h>
 
 namespace {
     using namespace aoc;
@@ -63,7 +65,12 @@ namespace {
         return in;
     }
 
-    using straight_t = std::tuple<ivec2, ivec2, std::size_t>; // pos, vec, pos_total_move
+    // start of a segment of a wire and steps walked to reach it
+    struct walk_t {
+        ivec2 start;
+        std::size_t steps;
+    };
+    using segments_t = ddr::math::orthogonal_segments<std::intmax_t, walk_t>;
 
     auto to_vec(const move_t& move) -> ivec2
     {
@@ -78,165 +85,62 @@ namespace {
         }
     }
 
-    template<bool partA>
-    auto min_cross_intersections(std::bool_constant<partA>, const straight_t& s, const std::vector<straight_t>& segments) noexcept -> std::optional<std::size_t>
-    {
-        const auto&[p0, v0, s0] = s;
-
-        // assume x coordinate where s projects into a line
-        std::size_t idx_x = (v0.x == 0) ? 0 : 1;
-        std::size_t idx_y = (v0.x == 0) ? 1 : 0;
-
-        // obtain relevant coordinates
-        auto x = p0[idx_x];
-        auto y0 = p0[idx_y];
-        auto y1 = p0[idx_y] + v0[idx_y];
-
-        auto y_min = std::min(y0, y1);
-        auto y_max = std::max(y0, y1);
-
-        // get candidates to intersect
-        auto it = std::lower_bound(segments.begin(), segments.end(), y_min, [idx_y](const auto& elem, const auto& value) {
-            return std::get<0>(elem)[idx_y] < value;
-        });
-        auto last = std::upper_bound(segments.begin(), segments.end(), y_max, [idx_y](const auto& value, const auto& elem) {
-            return value < std::get<0>(elem)[idx_y];
-        });
-
-        // check each intersection point
-        std::optional<std::size_t> dist;
-        for (; it != last; ++it) {
-            const auto&[p1, v1, s1] = *it;
-
-            auto y = p1[idx_y];
-            auto x0 = p1[idx_x];
-            auto x1 = p1[idx_x] + v1[idx_x];
-
-            auto x_min = std::min(x0, x1);
-            auto x_max = std::max(x0, x1);
-
-            if (x >= x_min && x <= x_max) {
-                // intersection point has coordinates x and y
-                std::size_t d;
-                if constexpr (partA) {
-                    d = std::size_t(std::abs(x) + std::abs(y));
-                } else {
-                    d = s0 + s1;
-                    ivec2 intersection_point;
-                    intersection_point[idx_x] = x;
-                    intersection_point[idx_y] = y;
-
-                    d += manh(intersection_point, p0);
-                    d += manh(intersection_point, p1);
-                }
-                if (d != 0)
-                    dist = dist ? std::min(*dist, d) : d;
-            }
-        }
-
-        return dist;
-    }
-
-
-    // TODO: current implementation only handles crossing intersections and do not consider intersections
-    //       where both segments are coincident
-    // template<bool partA>
-    // auto min_parallel_intersections(std::bool_constant<partA>, const straight_t& s, const std::vector<straight_t>& lines) -> std::optional<std::size_t>
-    // {
-    //     const auto&[p0, v0, s0] = s;
-
-    //     // assume x the coordinate that does not vary
-    //     std::size_t idx_x = (v0[0] == 0) ? 0 : 1;
-    //     std::size_t idx_y = (v0[0] == 0) ? 1 : 0;
-
-    //     // obtain relevant coordinates
-    //     auto x = p0[idx_x];
-    //     auto c0_y0 = p0[idx_y];
-    //     auto c0_y1 = p0[idx_y] + v0[idx_y];
-
-    //     auto c0_ymin = std::min(c0_y0, c0_y1);
-    //     auto c0_ymax = std::max(c0_y0, c0_y1);
-
-    //     // do equal range on x
-    //     auto it   = std::lower_bound(lines.begin(), lines.end(), x, [x_idx](const auto& elem, const auto& value) {
-    //         return std::get<0>(elem)[x_idx] < value;
-    //     });
-    //     auto last = std::upper_bound(lines.begin(), lines.end(), x, [x_idx](const auto& value, const auto& elem) {
-    //         return value < std::get<0>(elem)[x_idx];
-    //     });
-
-    //     std::optional<std::size_t> dist;
-    //     for (; it != last; ++it) {
-    //         const auto&[p1, v1, s1] = *it;
-
-    //         auto c1_y0 = p1[idx_y];
-    //         auto c1_y1 = p1[idx_y] + v1[idx_y];
-
-    //         auto c1_ymin = std::min(c1_y0, c1_y1);
-    //         auto c1_ymax = std::max(c1_y0, c1_y1);
-
-
-    //         if (c0_ymin <= c1_ymax && c1_ymin <= c0_ymax) {
-    //             // intersection occur, find all the range of intersection
-    //             auto y_inter_min = std::max(c0_ymin, c1_ymin);
-    //             auto y_inter_max = std::min(c0_ymax, c1_ymax);
-
-    //             if constexpr (partA) { // manhattan distance
-    //                 // two cases, y_inter_min * y_inter_max > 0:
-    //                 //  then the value of intersection is either y_inter_min or y_inter_max
-    //                 // y_inter_min * y_inter_max <= 0:
-    //                 //  then the value is 0 if x != 0, otherwise sign(y_inter_min) or sign(y_inter_max) (if different than 0)
-    //                 if (y_inter_min * y_inter_max > 0) {
-    //                     auto d = std::size_t(std::abs(x) + std::min(std::abs(y_inter_min), std::abs(y_inter_max)));
-    //                     dist = dist ? std::min(*dist, d) : d;
-    //                 } else if (x == 0) {
-    //                     if (y_inter_min != 0) y_inter_min /= std::abs(y_inter_min);
-    //                     if (y_inter_max != 0) y_inter_max /= std::abs(y_inter_max);
-
-    //                     auto d = std::size_t(std::max(std::abs(y_inter_min), std::abs(y_inter_max)));
-    //                     if (d != 0) dist = dist ? std::min(*dist, d) : d;
-    //                 } else {
-    //                     auto d = std::size_t(std::abs(x));
-    //                     dist = dist ? std::min(*dist, d) : d;
-    //                 }
-    //             } else {
-
-    //             }
-    //         }
-    //     }
-    //     return dist;
-    // }
-
     template<bool partA>
     auto result(const input_t& in) noexcept -> std::optional<std::size_t>
     {
-        // divide first curve into vertical and horizontal segments
-        std::vector<straight_t> vsegments; vsegments.reserve(in[0].size() / 2);
-        std::vector<straight_t> hsegments; hsegments.reserve(in[0].size() / 2);
+        // index the segments of the first curve
+        segments_t index;
         {
+            std::vector<segments_t::segment_type> hsegments, vsegments;
             std::size_t total_dist = 0;
             ivec2 pos = { 0, 0 };
             for (const auto& m : in[0]) {
                 auto vec = to_vec(m);
-                if (vec.x != 0) hsegments.emplace_back(pos, vec, total_dist);
-                else vsegments.emplace_back(pos, vec, total_dist);
-
+                segments_t::classify(pos, pos + vec, walk_t{ pos, total_dist }, hsegments, vsegments);
                 pos += vec;
                 total_dist += std::abs(vec.x) + std::abs(vec.y);
             }
-            std::sort(vsegments.begin(), vsegments.end(), [](const straight_t& lhs, const straight_t& rhs) { return std::get<0>(lhs).x < std::get<0>(rhs).x; });
-            std::sort(hsegments.begin(), hsegments.end(), [](const straight_t& lhs, const straight_t& rhs) { return std::get<0>(lhs).y < std::get<0>(rhs).y; });
+            // bulk build from segments sorted by (line, lo)
+            ddr::algorithm::radix_sorter<segments_t::segment_type> sorter;
+            for (auto* segments : { &hsegments, &vsegments }) {
+                sorter(segments->begin(), segments->end(), [](const auto& s) { return s.lo; });
+                sorter(segments->begin(), segments->end(), [](const auto& s) { return s.line; });
+            }
+            index = segments_t{ std::move(hsegments), std::move(vsegments) };
         }
 
+        // distance of an intersection point p of two segments
+        auto distance = [](const walk_t& w0, const walk_t& w1, const ivec2& p) -> std::size_t {
+            if constexpr (partA) return std::size_t(std::abs(p.x) + std::abs(p.y));
+            else return w0.steps + w1.steps + std::size_t(manh(p, w0.start) + manh(p, w1.start));
+        };
+
         std::optional<std::size_t> dist;
+        auto update = [&dist](std::size_t d) {
+            if (d != 0) dist = dist ? std::min(*dist, d) : d;
+        };
+
         ivec2 pos = { 0, 0 };
         std::size_t total_dist = 0;
         for (const auto& m : in[1]) {
             auto vec = to_vec(m);
-            straight_t s{pos, vec, total_dist};
-            const auto* cross = (vec.x == 0) ? &hsegments : &vsegments;
-            if (auto d = min_cross_intersections(std::bool_constant<partA>{}, s, *cross); d)
-                dist = dist ? std::min(*dist, *d) : *d;
+            walk_t w{ pos, total_dist };
+            index.crossing(pos, pos + vec, [&](const segments_t::segment_type& s, const ivec2& p) {
+                update(distance(s.value, w, p));
+            });
+            // Coincident segments intersect at every point of the common range. The distance along the
+            // range is convex and minimum at the origin (A) or at the start of the segment (B), clamped
+            // to the range; its neighbours are checked too, as the minimum may be the excluded origin.
+            std::size_t axis = (vec.y == 0) ? 0 : 1;
+            index.overlapping(pos, pos + vec, [&](const segments_t::segment_type& s, std::intmax_t lo, std::intmax_t hi) {
+                std::intmax_t best = std::clamp(partA ? std::intmax_t(0) : s.value.start[axis], lo, hi);
+                for (auto t : { best - 1, best, best + 1 }) {
+                    if (t < lo || t > hi) continue;
+                    ivec2 p = pos;
+                    p[axis] = t;
+                    update(distance(s.value, w, p));
+                }
+            });
             pos += vec;
             total_dist += std::abs(vec.x) + std::abs(vec.y);
         }
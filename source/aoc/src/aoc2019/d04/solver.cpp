@@ -14,6 +14,8 @@
 #include <cassert>
 #include <functional>
 
+#include <ddr/parallel/algorithm.h>
+
 namespace {
     using namespace aoc;
     constexpr std::size_t YEAR = 2019;
@@ -91,20 +93,20 @@ namespace {
 
     std::size_t passwords_A_between(std::uintmax_t lower, std::uintmax_t upper) noexcept
     {
-        std::size_t accum = 0;
-        for (std::uintmax_t x = lower; x < upper; ++x) {
-            if (auto ds = to_digits<6>(x); is_non_decreasing(ds.begin(), ds.end()) && contains_duplets(ds.begin(), ds.end())) ++accum;
-        }
-        return accum;
+        if (lower >= upper) return 0;
+        return ddr::parallel::parallel_reduce(0, std::size_t(upper - lower), std::size_t(0), [lower](std::size_t i) {
+            auto ds = to_digits<6>(lower + i);
+            return std::size_t(is_non_decreasing(ds.begin(), ds.end()) && contains_duplets(ds.begin(), ds.end()));
+        }, std::plus{});
     }
 
     std::size_t passwords_B_between(std::uintmax_t lower, std::uintmax_t upper) noexcept
     {
-        std::size_t accum = 0;
-        for (std::uintmax_t x = lower; x < upper; ++x) {
-            if (auto ds = to_digits<6>(x); is_non_decreasing(ds.begin(), ds.end()) && contains_unique_duplets(ds.begin(), ds.end())) ++accum;
-        }
-        return accum;
+        if (lower >= upper) return 0;
+        return ddr::parallel::parallel_reduce(0, std::size_t(upper - lower), std::size_t(0), [lower](std::size_t i) {
+            auto ds = to_digits<6>(lower + i);
+            return std::size_t(is_non_decreasing(ds.begin(), ds.end()) && contains_unique_duplets(ds.begin(), ds.end()));
+        }, std::plus{});
     }
 
 
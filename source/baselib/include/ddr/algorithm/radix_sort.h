@@ -0,0 +1,118 @@
+#ifndef INCLUDE_GUARD__DDR_ALGORITHM_RADIX_SORT_H__GUID_db5475c3_912f_43f8_ab7d_45aa685eb179
+#define INCLUDE_GUARD__DDR_ALGORITHM_RADIX_SORT_H__GUID_db5475c3_912f_43f8_ab7d_45aa685eb179
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace ddr::algorithm {
+
+    namespace detail {
+        struct identity {
+            template<typename T>
+            constexpr T&& operator()(T&& x) const noexcept { return std::forward<T>(x); }
+        };
+
+        template<typename K>
+        using radix_unsigned_t = std::make_unsigned_t<typename std::conditional_t<std::is_enum_v<K>, std::underlying_type<K>, std::common_type<K>>::type>;
+    }
+
+    // Stable LSD radix sort over 8-bit digits of an integral (or enum) key, the projection of each element.
+    // Keys are sorted by their offset to the smallest one, thus only the digits needed to represent the
+    // range of the keys are sorted, whatever their type and sign.
+    // The scratch buffer is kept between calls, so a sorter can be reused without allocating.
+    template<typename T>
+    class radix_sorter {
+    public:
+        using value_type = T;
+
+        template<typename RandomIt, typename Proj = detail::identity>
+        void operator()(RandomIt first, RandomIt last, Proj proj = {})
+        {
+            static_assert(std::is_same_v<typename std::iterator_traits<RandomIt>::value_type, T>, "the sorter must hold values of the same type");
+            using key_type = std::decay_t<std::invoke_result_t<Proj&, const T&>>;
+            static_assert(std::is_integral_v<key_type> || std::is_enum_v<key_type>, "radix sort needs integral keys");
+            using ukey_type = detail::radix_unsigned_t<key_type>;
+
+            std::size_t n = std::size_t(last - first);
+            auto key = [&proj](const T& x) { return ukey_type(std::invoke(proj, x)); };
+            if (n < small_size) {
+                std::stable_sort(first, last, [&](const T& lhs, const T& rhs) {
+                    return std::invoke(proj, lhs) < std::invoke(proj, rhs);
+                });
+                return;
+            }
+
+            // the minimum is taken in the ordering of the original type, differences are computed in unsigned arithmetic
+            auto [min_it, max_it] = std::minmax_element(first, last, [&](const T& lhs, const T& rhs) {
+                return std::invoke(proj, lhs) < std::invoke(proj, rhs);
+            });
+            ukey_type min_key = key(*min_it);
+            ukey_type range = ukey_type(key(*max_it) - min_key);
+            std::size_t passes = 0;
+            while (passes < sizeof(ukey_type) && (range >> (8 * passes)) != 0) ++passes;
+            if (passes == 0) return;
+
+            // histograms of all the digits in a single pass
+            counts_.assign(passes * 256, 0);
+            for (auto it = first; it != last; ++it) {
+                ukey_type k = ukey_type(key(*it) - min_key);
+                for (std::size_t p = 0; p < passes; ++p) ++counts_[p * 256 + ((k >> (8 * p)) & 0xff)];
+            }
+
+            buffer_.resize(n);
+            T* src_buf = nullptr;  // nullptr means that the data is in [first, last)
+            for (std::size_t p = 0; p < passes; ++p) {
+                std::size_t* count = &counts_[p * 256];
+                // a digit shared by all the keys does not reorder anything
+                if (count[(ukey_type(key(*first) - min_key) >> (8 * p)) & 0xff] == n) continue;
+
+                std::size_t offset = 0;
+                for (std::size_t d = 0; d < 256; ++d) offset += std::exchange(count[d], offset);
+
+                auto scatter = [&](auto src, auto dst) {
+                    for (std::size_t i = 0; i < n; ++i, ++src) {
+                        ukey_type k = ukey_type(key(*src) - min_key);
+                        dst[count[(k >> (8 * p)) & 0xff]++] = std::move(*src);
+                    }
+                };
+                if (src_buf == nullptr) {
+                    scatter(first, buffer_.data());
+                    src_buf = buffer_.data();
+                } else {
+                    scatter(buffer_.data(), first);
+                    src_buf = nullptr;
+                }
+            }
+            if (src_buf != nullptr) std::move(buffer_.begin(), buffer_.end(), first);
+        }
+
+        // releases the scratch memory
+        void shrink_to_fit() {
+            buffer_ = {};
+            counts_ = {};
+        }
+
+    private:
+        // below this size a comparison sort is faster than building the histograms
+        static constexpr std::size_t small_size = 64;
+
+        std::vector<T> buffer_;
+        std::vector<std::size_t> counts_;
+    };
+
+    // one-shot radix sort, see radix_sorter
+    template<typename RandomIt, typename Proj = detail::identity>
+    void radix_sort(RandomIt first, RandomIt last, Proj proj = {})
+    {
+        radix_sorter<typename std::iterator_traits<RandomIt>::value_type> sorter;
+        sorter(first, last, std::move(proj));
+    }
+}
+
+#endif // INCLUDE_GUARD__DDR_ALGORITHM_RADIX_SORT_H__GUID_db5475c3_912f_43f8_ab7d_45aa685eb179
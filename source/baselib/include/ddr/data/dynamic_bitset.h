@@ -0,0 +1,145 @@
+#ifndef INCLUDE_GUARD__DDR_DATA_DYNAMIC_BITSET_H__GUID_ac510216_f3f7_43f4_a138_2656a9aca1d2
+#define INCLUDE_GUARD__DDR_DATA_DYNAMIC_BITSET_H__GUID_ac510216_f3f7_43f4_a138_2656a9aca1d2
+
+#include <ddr/porting.h>
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace ddr::data {
+
+    // Bitset whose size is chosen at runtime. Bits are packed in 64-bit words and the bitwise
+    // operators are plain loops over the words, which the compiler vectorizes. The bits of the last
+    // word beyond size() are always kept cleared.
+    class dynamic_bitset {
+    public:
+        using word_type = std::uint64_t;
+        static constexpr std::size_t bits_per_word = 64;
+
+        dynamic_bitset() noexcept = default;
+        explicit dynamic_bitset(std::size_t size, bool value = false)
+            : words_(num_words(size), value ? ~word_type(0) : 0), size_(size)
+        {
+            clear_tail();
+        }
+
+        std::size_t size() const noexcept { return size_; }
+        bool empty() const noexcept { return size_ == 0; }
+
+        void resize(std::size_t size, bool value = false) {
+            if (value && size > size_) {
+                // fill the tail of the current last word before growing
+                if (size_ % bits_per_word != 0) words_.back() |= ~word_type(0) << (size_ % bits_per_word);
+            }
+            words_.resize(num_words(size), value ? ~word_type(0) : 0);
+            size_ = size;
+            clear_tail();
+        }
+
+        bool test(std::size_t i) const noexcept { assert(i < size_); return (words_[i / bits_per_word] >> (i % bits_per_word)) & 1; }
+        bool operator[](std::size_t i) const noexcept { return test(i); }
+
+        dynamic_bitset& set(std::size_t i) noexcept { assert(i < size_); words_[i / bits_per_word] |= bit(i); return *this; }
+        dynamic_bitset& set(std::size_t i, bool value) noexcept { return value ? set(i) : reset(i); }
+        dynamic_bitset& reset(std::size_t i) noexcept { assert(i < size_); words_[i / bits_per_word] &= ~bit(i); return *this; }
+        dynamic_bitset& flip(std::size_t i) noexcept { assert(i < size_); words_[i / bits_per_word] ^= bit(i); return *this; }
+
+        dynamic_bitset& set() noexcept { for (auto& w : words_) w = ~word_type(0); clear_tail(); return *this; }
+        dynamic_bitset& reset() noexcept { for (auto& w : words_) w = 0; return *this; }
+        dynamic_bitset& flip() noexcept { for (auto& w : words_) w = ~w; clear_tail(); return *this; }
+
+        bool any() const noexcept {
+            word_type acc = 0;
+            for (auto w : words_) acc |= w;
+            return acc != 0;
+        }
+        bool none() const noexcept { return !any(); }
+        bool all() const noexcept { return count() == size_; }
+        std::size_t count() const noexcept {
+            std::size_t n = 0;
+            for (auto w : words_) n += std::size_t(stdx::popcount(w));
+            return n;
+        }
+
+        // whether (*this & other).any(), without building the intersection
+        bool intersects(const dynamic_bitset& other) const noexcept {
+            assert(size_ == other.size_);
+            word_type acc = 0;
+            for (std::size_t i = 0; i < words_.size(); ++i) acc |= words_[i] & other.words_[i];
+            return acc != 0;
+        }
+
+        // index of the first bit set at or after i, size() if none
+        std::size_t find_next(std::size_t i) const noexcept {
+            if (i >= size_) return size_;
+            std::size_t w = i / bits_per_word;
+            word_type word = words_[w] & (~word_type(0) << (i % bits_per_word));
+            while (word == 0) {
+                if (++w == words_.size()) return size_;
+                word = words_[w];
+            }
+            return w * bits_per_word + std::size_t(stdx::countr_zero(word));
+        }
+        std::size_t find_first() const noexcept { return find_next(0); }
+
+        // f(i) for each bit i set, in increasing order
+        template<typename F>
+        void for_each_set(F&& f) const {
+            for (std::size_t w = 0; w < words_.size(); ++w) {
+                for (word_type word = words_[w]; word != 0; word &= word - 1) {
+                    f(w * bits_per_word + std::size_t(stdx::countr_zero(word)));
+                }
+            }
+        }
+
+        dynamic_bitset& operator&=(const dynamic_bitset& other) noexcept {
+            assert(size_ == other.size_);
+            for (std::size_t i = 0; i < words_.size(); ++i) words_[i] &= other.words_[i];
+            return *this;
+        }
+        dynamic_bitset& operator|=(const dynamic_bitset& other) noexcept {
+            assert(size_ == other.size_);
+            for (std::size_t i = 0; i < words_.size(); ++i) words_[i] |= other.words_[i];
+            return *this;
+        }
+        dynamic_bitset& operator^=(const dynamic_bitset& other) noexcept {
+            assert(size_ == other.size_);
+            for (std::size_t i = 0; i < words_.size(); ++i) words_[i] ^= other.words_[i];
+            return *this;
+        }
+        // *this &= ~other
+        dynamic_bitset& subtract(const dynamic_bitset& other) noexcept {
+            assert(size_ == other.size_);
+            for (std::size_t i = 0; i < words_.size(); ++i) words_[i] &= ~other.words_[i];
+            return *this;
+        }
+
+        friend dynamic_bitset operator&(dynamic_bitset lhs, const dynamic_bitset& rhs) noexcept { return lhs &= rhs; }
+        friend dynamic_bitset operator|(dynamic_bitset lhs, const dynamic_bitset& rhs) noexcept { return lhs |= rhs; }
+        friend dynamic_bitset operator^(dynamic_bitset lhs, const dynamic_bitset& rhs) noexcept { return lhs ^= rhs; }
+        friend dynamic_bitset operator~(dynamic_bitset x) noexcept { return x.flip(); }
+
+        friend bool operator==(const dynamic_bitset& lhs, const dynamic_bitset& rhs) noexcept { return lhs.size_ == rhs.size_ && lhs.words_ == rhs.words_; }
+        friend bool operator!=(const dynamic_bitset& lhs, const dynamic_bitset& rhs) noexcept { return !(lhs == rhs); }
+
+        // raw words, writers must keep the bits beyond size() cleared
+        const word_type* data() const noexcept { return words_.data(); }
+        word_type* data() noexcept { return words_.data(); }
+        std::size_t num_words() const noexcept { return words_.size(); }
+
+    private:
+        static std::size_t num_words(std::size_t bits) noexcept { return (bits + bits_per_word - 1) / bits_per_word; }
+        static word_type bit(std::size_t i) noexcept { return word_type(1) << (i % bits_per_word); }
+
+        void clear_tail() noexcept {
+            if (size_ % bits_per_word != 0) words_.back() &= ~(~word_type(0) << (size_ % bits_per_word));
+        }
+
+        std::vector<word_type> words_;
+        std::size_t size_ = 0;
+    };
+}
+
+#endif // INCLUDE_GUARD__DDR_DATA_DYNAMIC_BITSET_H__GUID_ac510216_f3f7_43f4_a138_2656a9aca1d2
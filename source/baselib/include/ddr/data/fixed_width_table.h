@@ -0,0 +1,118 @@
+#ifndef INCLUDE_GUARD__DDR_DATA_FIXED_WIDTH_TABLE_H__GUID_51bb73e5_17d3_4b4d_b7ce_f2bcd764564e
+#define INCLUDE_GUARD__DDR_DATA_FIXED_WIDTH_TABLE_H__GUID_51bb73e5_17d3_4b4d_b7ce_f2bcd764564e
+
+#include <ddr/porting.h>
+
+#include <vector>
+#include <string_view>
+#include <iterator>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace ddr::data {
+
+    namespace detail {
+        // bytes [p, p + n), n <= 8, with byte i in bits [8i, 8i+8) whatever the endianness
+        inline std::uint64_t load_bytes(const char* p, std::size_t n) noexcept
+        {
+            std::uint64_t word = 0;
+            for (std::size_t i = 0; i < n; ++i) word |= std::uint64_t(std::uint8_t(p[i])) << (8 * i);
+            return word;
+        }
+
+        // high bit of each byte of x set iff the byte is not zero, without carries across bytes
+        constexpr std::uint64_t nonzero_byte_mask(std::uint64_t x) noexcept
+        {
+            constexpr std::uint64_t low7 = 0x7f7f7f7f7f7f7f7fULL;
+            return (((x & low7) + low7) | x) & ~low7;
+        }
+        static_assert(nonzero_byte_mask(0) == 0);
+        static_assert(nonzero_byte_mask(0x0100ff0080007f00ULL) == 0x8000800080008000ULL);
+        static_assert(nonzero_byte_mask(0x0101010101010101ULL) == 0x8080808080808080ULL);
+        static_assert(nonzero_byte_mask(0xffffffffffffffffULL) == 0x8080808080808080ULL);
+
+        // number of non-zero bytes of x
+        inline int count_nonzero_bytes(std::uint64_t x) noexcept
+        {
+            return stdx::popcount(nonzero_byte_mask(x));
+        }
+    }
+
+    // Number of positions at which two strings of the same size differ, comparing 8 characters at a
+    // time. The count stops early once it exceeds limit, then the result is only known to be > limit.
+    inline std::size_t hamming_distance(std::string_view lhs, std::string_view rhs, std::size_t limit = std::size_t(-1)) noexcept
+    {
+        assert(lhs.size() == rhs.size());
+        std::size_t dist = 0;
+        for (std::size_t i = 0; i < lhs.size() && dist <= limit; i += 8) {
+            std::size_t n = std::min<std::size_t>(8, lhs.size() - i);
+            dist += std::size_t(detail::count_nonzero_bytes(detail::load_bytes(lhs.data() + i, n) ^ detail::load_bytes(rhs.data() + i, n)));
+        }
+        return dist;
+    }
+
+    // Table of strings that all have the same width, stored back to back in a single buffer:
+    // row i spans [i * width, (i + 1) * width) and is accessed as a string_view.
+    class fixed_width_table {
+    public:
+        class iterator {
+        public:
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::string_view;
+            using pointer = void;
+            using reference = std::string_view;
+            using iterator_category = std::forward_iterator_tag;
+
+            iterator() noexcept = default;
+            iterator(const fixed_width_table& table, std::size_t row) noexcept : table_(&table), row_(row) {}
+
+            iterator& operator++() noexcept { ++row_; return *this; }
+            iterator operator++(int) noexcept { auto cpy = *this; ++(*this); return cpy; }
+            friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept { return lhs.row_ == rhs.row_; }
+            friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept { return !(lhs == rhs); }
+            std::string_view operator*() const noexcept { return (*table_)[row_]; }
+
+        private:
+            const fixed_width_table* table_ = nullptr;
+            std::size_t row_ = 0;
+        };
+
+        explicit fixed_width_table(std::size_t width = 0) noexcept : width_(width) {}
+
+        std::size_t width() const noexcept { return width_; }
+        std::size_t size() const noexcept { return rows_; }
+        bool empty() const noexcept { return size() == 0; }
+
+        void reserve(std::size_t rows) { chars_.reserve(rows * width_); }
+
+        void push_back(std::string_view row) {
+            assert(row.size() == width_);
+            chars_.insert(chars_.end(), row.begin(), row.end());
+            ++rows_;
+        }
+
+        std::string_view operator[](std::size_t i) const noexcept {
+            assert(i < size());
+            return { chars_.data() + i * width_, width_ };
+        }
+
+        // all the rows, back to back
+        const char* data() const noexcept { return chars_.data(); }
+
+        std::size_t hamming_distance(std::size_t i, std::size_t j, std::size_t limit = std::size_t(-1)) const noexcept {
+            return data::hamming_distance((*this)[i], (*this)[j], limit);
+        }
+
+        iterator begin() const noexcept { return { *this, 0 }; }
+        iterator end() const noexcept { return { *this, size() }; }
+
+    private:
+        std::size_t width_;
+        std::size_t rows_ = 0;
+        std::vector<char> chars_;
+    };
+}
+
+#endif // INCLUDE_GUARD__DDR_DATA_FIXED_WIDTH_TABLE_H__GUID_51bb73e5_17d3_4b4d_b7ce_f2bcd764564e
@@ -0,0 +1,399 @@
+#ifndef INCLUDE_GUARD__DDR_DATA_FLAT_HASH_H__GUID_b86141a2_8414_4a41_9943_b8b04e4c2ce3
+#define INCLUDE_GUARD__DDR_DATA_FLAT_HASH_H__GUID_b86141a2_8414_4a41_9943_b8b04e4c2ce3
+
+#include <ddr/porting.h>
+
+#include <memory>
+#include <functional>
+#include <utility>
+#include <tuple>
+#include <iterator>
+#include <type_traits>
+#include <stdexcept>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace ddr::data {
+
+    namespace detail {
+        // finalizer of MurmurHash3, every bit of the result depends on every bit of x
+        constexpr std::uint64_t mix64(std::uint64_t x) noexcept {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ULL;
+            x ^= x >> 33;
+            return x;
+        }
+    }
+
+    // Default hash of the flat containers. The table takes a 7-bit tag from the low bits of the hash
+    // and the group from the bits just above them, thus integers (whose std::hash is usually the
+    // identity) are mixed so that consecutive keys neither cluster nor share tags.
+    template<typename T, typename = void>
+    struct flat_hash {
+        std::size_t operator()(const T& x) const noexcept(noexcept(std::hash<T>{}(x))) {
+            return std::size_t(detail::mix64(std::hash<T>{}(x)));
+        }
+    };
+
+    template<typename T>
+    struct flat_hash<T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>> {
+        std::size_t operator()(T x) const noexcept { return std::size_t(detail::mix64(std::uint64_t(x))); }
+    };
+
+    namespace detail {
+        // Control byte of each slot: empty, deleted (tombstone) or full, in which case it holds
+        // the 7-bit tag of the hash of its key (so its sign bit is clear).
+        using ctrl_t = std::int8_t;
+        constexpr ctrl_t ctrl_empty = -128;  // 0b10000000
+        constexpr ctrl_t ctrl_deleted = -2;  // 0b11111110
+
+        // set of slots of a group, one bit (the high one of the byte) per slot
+        class group_mask {
+        public:
+            explicit group_mask(std::uint64_t mask) noexcept : mask_(mask) {}
+            explicit operator bool() const noexcept { return mask_ != 0; }
+            std::size_t lowest() const noexcept { return std::size_t(stdx::countr_zero(mask_)) / 8; }
+
+            // iterable as the indices of the slots, in increasing order
+            group_mask begin() const noexcept { return *this; }
+            group_mask end() const noexcept { return group_mask{ 0 }; }
+            std::size_t operator*() const noexcept { return lowest(); }
+            group_mask& operator++() noexcept { mask_ &= mask_ - 1; return *this; }
+            friend bool operator!=(const group_mask& lhs, const group_mask& rhs) noexcept { return lhs.mask_ != rhs.mask_; }
+
+        private:
+            std::uint64_t mask_;
+        };
+
+        // The control bytes of a group are matched all at once with 64-bit arithmetic (SIMD within
+        // a register), which every target supports and compiles to a handful of instructions.
+        struct ctrl_group {
+            static constexpr std::size_t width = 8;
+            static constexpr std::uint64_t lsbs = 0x0101010101010101ULL;
+            static constexpr std::uint64_t msbs = 0x8080808080808080ULL;
+
+            explicit ctrl_group(const ctrl_t* p) noexcept {
+                // byte i goes to bits [8i, 8i+8) whatever the endianness, it is a single load on little endian
+                for (std::size_t i = 0; i < width; ++i) word |= std::uint64_t(std::uint8_t(p[i])) << (8 * i);
+            }
+
+            // Full slots whose tag may be tag: the zero byte detection may flag a byte after a
+            // matching one, but never an empty or deleted slot, as their high bit survives the xor.
+            group_mask match(ctrl_t tag) const noexcept {
+                std::uint64_t x = word ^ (lsbs * std::uint8_t(tag));
+                return group_mask{ (x - lsbs) & ~x & msbs };
+            }
+            // only empty slots have the high bit set and bit 1 clear
+            group_mask match_empty() const noexcept { return group_mask{ word & ~(word << 6) & msbs }; }
+            group_mask match_empty_or_deleted() const noexcept { return group_mask{ word & msbs }; }
+
+            std::uint64_t word = 0;
+        };
+
+        struct key_identity {
+            template<typename T>
+            const T& operator()(const T& x) const noexcept { return x; }
+        };
+
+        struct key_first {
+            template<typename T>
+            const auto& operator()(const T& x) const noexcept { return x.first; }
+        };
+
+        // Open-addressing hash table storing the values inline. Slots are split in groups of
+        // ctrl_group::width, the groups are probed following a triangular sequence (which visits all of
+        // them as their count is a power of two) and a lookup stops at the first group with an empty slot.
+        // Erased slots become tombstones unless their group has an empty slot (then no probe can pass
+        // through it). The load factor, tombstones included, is kept under 7/8.
+        template<typename Value, typename Key, typename KeyOf, typename Hash, typename KeyEqual>
+        class flat_table {
+        public:
+            using key_type = Key;
+            using value_type = Value;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+            using hasher = Hash;
+            using key_equal = KeyEqual;
+            using reference = value_type&;
+            using const_reference = const value_type&;
+
+            template<bool Const>
+            class iterator_impl {
+                using table_ptr = std::conditional_t<Const, const flat_table*, flat_table*>;
+            public:
+                using difference_type = std::ptrdiff_t;
+                using value_type = Value;
+                using pointer = std::conditional_t<Const, const Value*, Value*>;
+                using reference = std::conditional_t<Const, const Value&, Value&>;
+                using iterator_category = std::forward_iterator_tag;
+
+                iterator_impl() noexcept = default;
+                template<bool C = Const, typename = std::enable_if_t<C>>
+                iterator_impl(const iterator_impl<false>& other) noexcept : table_(other.table_), idx_(other.idx_) {}
+
+                reference operator*() const noexcept { return table_->slot(idx_); }
+                pointer operator->() const noexcept { return &table_->slot(idx_); }
+                iterator_impl& operator++() noexcept { ++idx_; skip_free(); return *this; }
+                iterator_impl operator++(int) noexcept { auto cpy = *this; ++(*this); return cpy; }
+
+                friend bool operator==(const iterator_impl& lhs, const iterator_impl& rhs) noexcept { return lhs.idx_ == rhs.idx_; }
+                friend bool operator!=(const iterator_impl& lhs, const iterator_impl& rhs) noexcept { return lhs.idx_ != rhs.idx_; }
+
+            private:
+                friend class flat_table;
+                friend class iterator_impl<!Const>;
+
+                iterator_impl(table_ptr table, std::size_t idx) noexcept : table_(table), idx_(idx) { skip_free(); }
+                void skip_free() noexcept { while (idx_ < table_->capacity_ && table_->ctrl_[idx_] < 0) ++idx_; }
+
+                table_ptr table_ = nullptr;
+                std::size_t idx_ = 0;
+            };
+
+            using iterator = iterator_impl<false>;
+            using const_iterator = iterator_impl<true>;
+
+            flat_table() = default;
+            explicit flat_table(size_type n) { reserve(n); }
+            // stateful hash and equality, e.g. keys that are indices into some other storage
+            flat_table(size_type n, const hasher& hash, const key_equal& eq = key_equal{}) : hash_(hash), eq_(eq) { reserve(n); }
+            template<typename InputIt>
+            flat_table(InputIt first, InputIt last) { insert(first, last); }
+            flat_table(std::initializer_list<value_type> il) : flat_table(il.begin(), il.end()) {}
+
+            flat_table(const flat_table& other) : hash_(other.hash_), eq_(other.eq_)
+            {
+                reserve(other.size_);
+                for (const auto& v : other) emplace_unique(KeyOf{}(v), v);
+            }
+            flat_table(flat_table&& other) noexcept
+                : ctrl_(std::move(other.ctrl_)), slots_(std::move(other.slots_))
+                , capacity_(std::exchange(other.capacity_, 0)), size_(std::exchange(other.size_, 0))
+                , growth_left_(std::exchange(other.growth_left_, 0)), hash_(other.hash_), eq_(other.eq_)
+            {}
+            flat_table& operator=(flat_table other) noexcept { swap(other); return *this; }
+            ~flat_table() noexcept { destroy_all(); }
+
+            void swap(flat_table& other) noexcept {
+                using std::swap;
+                swap(ctrl_, other.ctrl_);
+                swap(slots_, other.slots_);
+                swap(capacity_, other.capacity_);
+                swap(size_, other.size_);
+                swap(growth_left_, other.growth_left_);
+                swap(hash_, other.hash_);
+                swap(eq_, other.eq_);
+            }
+            friend void swap(flat_table& lhs, flat_table& rhs) noexcept { lhs.swap(rhs); }
+
+            iterator begin() noexcept { return { this, 0 }; }
+            iterator end() noexcept { return { this, capacity_ }; }
+            const_iterator begin() const noexcept { return { this, 0 }; }
+            const_iterator end() const noexcept { return { this, capacity_ }; }
+            const_iterator cbegin() const noexcept { return begin(); }
+            const_iterator cend() const noexcept { return end(); }
+
+            size_type size() const noexcept { return size_; }
+            bool empty() const noexcept { return size_ == 0; }
+            size_type capacity() const noexcept { return capacity_; }
+
+            void clear() noexcept {
+                destroy_all();
+                for (std::size_t i = 0; i < capacity_; ++i) ctrl_[i] = ctrl_empty;
+                size_ = 0;
+                growth_left_ = max_load(capacity_);
+            }
+
+            // ensures that n elements fit without rehashing
+            void reserve(size_type n) {
+                if (n > size_ && n - size_ > growth_left_) rehash(capacity_for(n));
+            }
+
+            std::pair<iterator, bool> insert(const value_type& v) { return emplace_unique(KeyOf{}(v), v); }
+            std::pair<iterator, bool> insert(value_type&& v) { return emplace_unique(KeyOf{}(v), std::move(v)); }
+            template<typename InputIt>
+            void insert(InputIt first, InputIt last) {
+                if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>) {
+                    reserve(size_ + std::size_t(std::distance(first, last)));
+                }
+                for (; first != last; ++first) insert(*first);
+            }
+
+            iterator find(const key_type& key) noexcept { return { this, find_index(key, hash_(key)) }; }
+            const_iterator find(const key_type& key) const noexcept { return { this, find_index(key, hash_(key)) }; }
+            bool contains(const key_type& key) const noexcept { return find_index(key, hash_(key)) != capacity_; }
+            size_type count(const key_type& key) const noexcept { return contains(key) ? 1 : 0; }
+
+            size_type erase(const key_type& key) noexcept {
+                std::size_t idx = find_index(key, hash_(key));
+                if (idx == capacity_) return 0;
+                erase_at(idx);
+                return 1;
+            }
+            iterator erase(const_iterator pos) noexcept {
+                erase_at(pos.idx_);
+                return { this, pos.idx_ + 1 };
+            }
+
+        protected:
+            // constructs the value from args if key is not present
+            template<typename... Args>
+            std::pair<iterator, bool> emplace_unique(const key_type& key, Args&&... args)
+            {
+                std::size_t h = hash_(key);
+                if (std::size_t idx = find_index(key, h); idx != capacity_) return { iterator{ this, idx }, false };
+                if (growth_left_ == 0) grow();
+                std::size_t idx = find_free(h);
+                ::new (static_cast<void*>(&slots_[idx])) value_type(std::forward<Args>(args)...);
+                if (ctrl_[idx] == ctrl_empty) --growth_left_;
+                ctrl_[idx] = tag(h);
+                ++size_;
+                return { iterator{ this, idx }, true };
+            }
+
+        private:
+            using group = ctrl_group;
+            static constexpr std::size_t width = group::width;
+
+            struct alignas(value_type) slot_type {
+                unsigned char bytes[sizeof(value_type)];
+            };
+
+            static std::size_t max_load(std::size_t capacity) noexcept { return capacity - capacity / 8; }
+            static std::size_t capacity_for(std::size_t n) noexcept {
+                std::size_t capacity = width;
+                while (max_load(capacity) < n) capacity *= 2;
+                return capacity;
+            }
+
+            static std::size_t group_of(std::size_t h) noexcept { return h >> 7; }
+            static ctrl_t tag(std::size_t h) noexcept { return ctrl_t(h & 0x7f); }
+
+            value_type& slot(std::size_t idx) noexcept { return *std::launder(reinterpret_cast<value_type*>(&slots_[idx])); }
+            const value_type& slot(std::size_t idx) const noexcept { return *std::launder(reinterpret_cast<const value_type*>(&slots_[idx])); }
+
+            // index of the slot holding key, capacity_ if none
+            std::size_t find_index(const key_type& key, std::size_t h) const noexcept {
+                if (capacity_ == 0) return capacity_;
+                std::size_t mask = capacity_ / width - 1;
+                std::size_t g = group_of(h) & mask;
+                ctrl_t t = tag(h);
+                for (std::size_t step = 1; ; ++step) {
+                    group grp{ &ctrl_[g * width] };
+                    for (std::size_t i : grp.match(t)) {
+                        std::size_t idx = g * width + i;
+                        if (eq_(KeyOf{}(slot(idx)), key)) return idx;
+                    }
+                    if (grp.match_empty()) return capacity_;
+                    g = (g + step) & mask;
+                }
+            }
+
+            // first empty or deleted slot in the probe sequence of h, there is always one
+            std::size_t find_free(std::size_t h) const noexcept {
+                assert(capacity_ > 0);
+                std::size_t mask = capacity_ / width - 1;
+                std::size_t g = group_of(h) & mask;
+                for (std::size_t step = 1; ; ++step) {
+                    if (auto free = group{ &ctrl_[g * width] }.match_empty_or_deleted()) return g * width + free.lowest();
+                    g = (g + step) & mask;
+                }
+            }
+
+            void erase_at(std::size_t idx) noexcept {
+                assert(idx < capacity_ && ctrl_[idx] >= 0);
+                slot(idx).~value_type();
+                --size_;
+                if (group{ &ctrl_[idx / width * width] }.match_empty()) {
+                    ctrl_[idx] = ctrl_empty;
+                    ++growth_left_;
+                } else {
+                    ctrl_[idx] = ctrl_deleted;
+                }
+            }
+
+            // doubles the capacity, unless tombstones take most of the load, which are just purged
+            void grow() {
+                if (capacity_ != 0 && size_ <= max_load(capacity_) / 2) rehash(capacity_);
+                else rehash(capacity_ == 0 ? width : 2 * capacity_);
+            }
+
+            void rehash(std::size_t capacity) {
+                assert(capacity % width == 0 && max_load(capacity) >= size_);
+                std::unique_ptr<ctrl_t[]> ctrl{ new ctrl_t[capacity] };
+                std::unique_ptr<slot_type[]> slots{ new slot_type[capacity] };
+                for (std::size_t i = 0; i < capacity; ++i) ctrl[i] = ctrl_empty;
+
+                std::swap(ctrl, ctrl_);
+                std::swap(slots, slots_);
+                std::size_t old_capacity = std::exchange(capacity_, capacity);
+                for (std::size_t i = 0; i < old_capacity; ++i) {
+                    if (ctrl[i] < 0) continue;
+                    auto& v = *std::launder(reinterpret_cast<value_type*>(&slots[i]));
+                    std::size_t h = hash_(KeyOf{}(v));
+                    std::size_t idx = find_free(h);
+                    ::new (static_cast<void*>(&slots_[idx])) value_type(std::move(v));
+                    ctrl_[idx] = tag(h);
+                    v.~value_type();
+                }
+                growth_left_ = max_load(capacity) - size_;
+            }
+
+            void destroy_all() noexcept {
+                if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                    for (std::size_t i = 0; i < capacity_; ++i) {
+                        if (ctrl_[i] >= 0) slot(i).~value_type();
+                    }
+                }
+            }
+
+            std::unique_ptr<ctrl_t[]> ctrl_;
+            std::unique_ptr<slot_type[]> slots_;
+            std::size_t capacity_ = 0;
+            std::size_t size_ = 0;
+            std::size_t growth_left_ = 0;
+            hasher hash_;
+            key_equal eq_;
+        };
+    }
+
+    template<typename Key, typename Hash = flat_hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    class flat_hash_set : public detail::flat_table<Key, Key, detail::key_identity, Hash, KeyEqual> {
+        using base = detail::flat_table<Key, Key, detail::key_identity, Hash, KeyEqual>;
+    public:
+        using base::base;
+    };
+
+    template<typename Key, typename T, typename Hash = flat_hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    class flat_hash_map : public detail::flat_table<std::pair<const Key, T>, Key, detail::key_first, Hash, KeyEqual> {
+        using base = detail::flat_table<std::pair<const Key, T>, Key, detail::key_first, Hash, KeyEqual>;
+    public:
+        using mapped_type = T;
+        using typename base::iterator;
+        using base::base;
+
+        template<typename... Args>
+        std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+            return this->emplace_unique(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        T& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+        T& at(const Key& key) {
+            auto it = this->find(key);
+            if (it == this->end()) throw std::out_of_range{ "flat_hash_map::at" };
+            return it->second;
+        }
+        const T& at(const Key& key) const {
+            auto it = this->find(key);
+            if (it == this->end()) throw std::out_of_range{ "flat_hash_map::at" };
+            return it->second;
+        }
+    };
+}
+
+#endif // INCLUDE_GUARD__DDR_DATA_FLAT_HASH_H__GUID_b86141a2_8414_4a41_9943_b8b04e4c2ce3
@@ -2,13 +2,32 @@
 #define INCLUDE_GUARD__DDR_DATA_TREE_H__GUID_8bac1f36_92ed_4d75_8fba_cc0859a0a81a
 
 #include <vector>
+#include <memory>
+#include <memory_resource>
+#include <cstddef>
+#include <cassert>
+#include <iterator>
+#include <utility>
 
 namespace ddr::data {
 
-    template<typename T>
+    // Node owning its children. With a std::pmr::polymorphic_allocator (see pmr::node_t) the
+    // allocator propagates to all the descendants, so a whole tree can live in a single arena.
+    template<typename T, template<typename> class Allocator = std::allocator>
     struct node_t {
-        std::vector<node_t> children;
-        T data;
+        using allocator_type = Allocator<node_t>;
+
+        std::vector<node_t, allocator_type> children;
+        T data{};
+
+        node_t() = default;
+        explicit node_t(const allocator_type& alloc) : children(alloc) {}
+        node_t(const node_t& other, const allocator_type& alloc) : children(other.children, alloc), data(other.data) {}
+        node_t(node_t&& other, const allocator_type& alloc) : children(std::move(other.children), alloc), data(std::move(other.data)) {}
+        node_t(const node_t&) = default;
+        node_t(node_t&&) = default;
+        node_t& operator=(const node_t&) = default;
+        node_t& operator=(node_t&&) = default;
 
         T& operator*() noexcept { return data; }
         const T& operator*() const noexcept { return data; }
@@ -16,6 +35,151 @@ namespace ddr::data {
         const T* operator->() const noexcept { return &data; }
     };
 
+    namespace pmr {
+        template<typename T>
+        using node_t = data::node_t<T, std::pmr::polymorphic_allocator>;
+    }
+
+    // Tree stored in two arrays: the nodes, in pre-order, and the payloads of all the nodes.
+    // Each node holds a (possibly empty) contiguous sequence of T inside the payload pool.
+    // As nodes are in pre-order, the subtree of node i spans [i, i + subtree_size(i)), its first
+    // child (if any) is i + 1 and the next sibling of a child c is c + subtree_size(c).
+    // Moreover, iterating the nodes backwards visits all descendants of a node before the node itself.
+    template<typename T>
+    class flat_tree {
+    public:
+        using node_id = std::size_t;
+        using value_type = T;
+
+        // contiguous range of payload values
+        template<typename U>
+        class range {
+        public:
+            range(U* first, U* last) noexcept : first_(first), last_(last) {}
+            U* begin() const noexcept { return first_; }
+            U* end() const noexcept { return last_; }
+            std::size_t size() const noexcept { return std::size_t(last_ - first_); }
+            bool empty() const noexcept { return first_ == last_; }
+            U& operator[](std::size_t i) const noexcept { assert(i < size()); return first_[i]; }
+        private:
+            U* first_;
+            U* last_;
+        };
+
+        // forward iterator over the children of a node
+        class child_iterator {
+        public:
+            using difference_type = std::ptrdiff_t;
+            using value_type = node_id;
+            using pointer = const node_id*;
+            using reference = const node_id&;
+            using iterator_category = std::forward_iterator_tag;
+
+            child_iterator(const flat_tree& tree, node_id node) noexcept : tree_(&tree), node_(node) {}
+            child_iterator& operator++() noexcept { node_ += tree_->subtree_size(node_); return *this; }
+            child_iterator operator++(int) noexcept { auto cpy = *this; ++(*this); return cpy; }
+            friend bool operator==(const child_iterator& lhs, const child_iterator& rhs) noexcept { return lhs.node_ == rhs.node_; }
+            friend bool operator!=(const child_iterator& lhs, const child_iterator& rhs) noexcept { return !(lhs == rhs); }
+            reference operator*() const noexcept { return node_; }
+            pointer operator->() const noexcept { return &node_; }
+        private:
+            const flat_tree* tree_;
+            node_id node_;
+        };
+
+        struct children_range {
+            child_iterator first, last;
+            child_iterator begin() const noexcept { return first; }
+            child_iterator end() const noexcept { return last; }
+        };
+
+        static constexpr node_id root() noexcept { return 0; }
+
+        void reserve(std::size_t nodes, std::size_t values) { nodes_.reserve(nodes); pool_.reserve(values); }
+        void clear() noexcept { nodes_.clear(); pool_.clear(); }
+
+        // Building: nodes must be opened in pre-order and closed once all their descendants are closed.
+        // Payload values may be pushed at any moment between opening and closing the node, as long as
+        // the values of a node are pushed consecutively.
+        node_id open_node(std::size_t num_children) {
+            nodes_.push_back({ num_children, 0, pool_.size(), pool_.size() });
+            return nodes_.size() - 1;
+        }
+        void push_value(node_id node, T value) {
+            auto& n = nodes_[node];
+            assert(n.subtree_size == 0);
+            if (n.data_first == n.data_last) n.data_first = n.data_last = pool_.size();
+            assert(n.data_last == pool_.size());
+            pool_.push_back(std::move(value));
+            ++n.data_last;
+        }
+        void close_node(node_id node) noexcept {
+            assert(node < nodes_.size());
+            nodes_[node].subtree_size = nodes_.size() - node;
+        }
+
+        std::size_t size() const noexcept { return nodes_.size(); }
+        bool empty() const noexcept { return nodes_.empty(); }
+
+        std::size_t num_children(node_id node) const noexcept { return nodes_[node].num_children; }
+        std::size_t subtree_size(node_id node) const noexcept { return nodes_[node].subtree_size; }
+        bool is_leaf(node_id node) const noexcept { return nodes_[node].num_children == 0; }
+
+        children_range children(node_id node) const noexcept {
+            return { { *this, node + 1 }, { *this, node + subtree_size(node) } };
+        }
+
+        // i-th child of node, costs O(i)
+        node_id child(node_id node, std::size_t i) const noexcept {
+            assert(i < num_children(node));
+            auto it = children(node).begin();
+            std::advance(it, i);
+            return *it;
+        }
+
+        range<T> data(node_id node) noexcept { return { pool_.data() + nodes_[node].data_first, pool_.data() + nodes_[node].data_last }; }
+        range<const T> data(node_id node) const noexcept { return { pool_.data() + nodes_[node].data_first, pool_.data() + nodes_[node].data_last }; }
+
+        // payloads of all the nodes
+        const std::vector<T>& pool() const noexcept { return pool_; }
+
+        // f(node) for every node, parents before children
+        template<typename F>
+        void visit_preorder(F&& f) const {
+            for (node_id i = 0; i < nodes_.size(); ++i) f(i);
+        }
+
+        // f(node) for every node, children (in order) before parents
+        template<typename F>
+        void visit_postorder(F&& f) const {
+            // stack of (node, next child to visit)
+            std::vector<std::pair<node_id, node_id>> stack;
+            if (!empty()) stack.emplace_back(root(), root() + 1);
+            while (!stack.empty()) {
+                auto& [node, next] = stack.back();
+                if (next < node + subtree_size(node)) {
+                    node_id c = next;
+                    next += subtree_size(c);
+                    stack.emplace_back(c, c + 1);
+                } else {
+                    f(node);
+                    stack.pop_back();
+                }
+            }
+        }
+
+    private:
+        struct node_rec {
+            std::size_t num_children;
+            std::size_t subtree_size;
+            std::size_t data_first;
+            std::size_t data_last;
+        };
+
+        std::vector<node_rec> nodes_;
+        std::vector<T> pool_;
+    };
+
 };
 
-#endif // INCLUDE_GUARD__DDR_DATA_TREE_H__GUID_8bac1f36_92ed_4d75_8fba_cc0859a0a81a
\ No newline at end of file
+#endif // INCLUDE_GUARD__DDR_DATA_TREE_H__GUID_8bac1f36_92ed_4d75_8fba_cc0859a0a81a
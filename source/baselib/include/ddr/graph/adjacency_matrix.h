@@ -0,0 +1,55 @@
+#ifndef INCLUDE_GUARD__DDR_GRAPH_ADJACENCY_MATRIX_H__GUID_cefcf6b4_174b_4c2a_ad03_5776a3116bdb
+#define INCLUDE_GUARD__DDR_GRAPH_ADJACENCY_MATRIX_H__GUID_cefcf6b4_174b_4c2a_ad03_5776a3116bdb
+
+#include <ddr/data/dynamic_bitset.h>
+
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+namespace ddr::graph {
+
+    using vertex_id = std::size_t;
+
+    // Dense directed graph of a fixed number of vertices. The successors and the predecessors of each
+    // vertex are kept as bit rows, so that set operations over neighbourhoods are word operations.
+    class adjacency_matrix {
+    public:
+        adjacency_matrix() = default;
+        explicit adjacency_matrix(std::size_t n) : out_(n, data::dynamic_bitset(n)), in_(n, data::dynamic_bitset(n)) {}
+
+        std::size_t size() const noexcept { return out_.size(); }
+
+        void add_edge(vertex_id from, vertex_id to) noexcept {
+            assert(from < size() && to < size());
+            out_[from].set(to);
+            in_[to].set(from);
+        }
+        void remove_edge(vertex_id from, vertex_id to) noexcept {
+            assert(from < size() && to < size());
+            out_[from].reset(to);
+            in_[to].reset(from);
+        }
+        bool has_edge(vertex_id from, vertex_id to) const noexcept { return out_[from].test(to); }
+
+        const data::dynamic_bitset& successors(vertex_id v) const noexcept { return out_[v]; }
+        const data::dynamic_bitset& predecessors(vertex_id v) const noexcept { return in_[v]; }
+        std::size_t out_degree(vertex_id v) const noexcept { return out_[v].count(); }
+        std::size_t in_degree(vertex_id v) const noexcept { return in_[v].count(); }
+
+        std::size_t num_edges() const noexcept {
+            std::size_t n = 0;
+            for (const auto& row : out_) n += row.count();
+            return n;
+        }
+
+        template<typename F>
+        void for_each_successor(vertex_id v, F&& f) const { out_[v].for_each_set(f); }
+
+    private:
+        std::vector<data::dynamic_bitset> out_;
+        std::vector<data::dynamic_bitset> in_;
+    };
+}
+
+#endif // INCLUDE_GUARD__DDR_GRAPH_ADJACENCY_MATRIX_H__GUID_cefcf6b4_174b_4c2a_ad03_5776a3116bdb
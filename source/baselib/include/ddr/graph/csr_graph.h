@@ -0,0 +1,74 @@
+#ifndef INCLUDE_GUARD__DDR_GRAPH_CSR_GRAPH_H__GUID_5bca35c4_8ba2_49a4_89e1_4e6aa945f93e
+#define INCLUDE_GUARD__DDR_GRAPH_CSR_GRAPH_H__GUID_5bca35c4_8ba2_49a4_89e1_4e6aa945f93e
+
+#include <vector>
+#include <tuple>
+#include <cstddef>
+#include <cassert>
+
+namespace ddr::graph {
+
+    using vertex_id = std::size_t;
+
+    // Sparse directed graph in compressed sparse row form: the successors of vertex v are
+    // targets[offsets[v], offsets[v+1]), in the order the edges were given.
+    class csr_graph {
+    public:
+        struct range {
+            const vertex_id* first;
+            const vertex_id* last;
+            const vertex_id* begin() const noexcept { return first; }
+            const vertex_id* end() const noexcept { return last; }
+            std::size_t size() const noexcept { return std::size_t(last - first); }
+            bool empty() const noexcept { return first == last; }
+        };
+
+        csr_graph() : offsets_(1, 0) {}
+
+        // Graph of n vertices from the edges in [first, last), pair-like (from, to) values.
+        // The range is traversed twice. Repeated edges are kept.
+        template<typename ForwardIt>
+        csr_graph(std::size_t n, ForwardIt first, ForwardIt last) : offsets_(n + 1, 0)
+        {
+            for (auto it = first; it != last; ++it) {
+                assert(vertex_id(std::get<0>(*it)) < n && vertex_id(std::get<1>(*it)) < n);
+                ++offsets_[vertex_id(std::get<0>(*it)) + 1];
+            }
+            for (std::size_t v = 0; v < n; ++v) offsets_[v + 1] += offsets_[v];
+
+            targets_.resize(offsets_[n]);
+            std::vector<std::size_t> next(offsets_.begin(), offsets_.end() - 1);
+            for (auto it = first; it != last; ++it) targets_[next[vertex_id(std::get<0>(*it))]++] = vertex_id(std::get<1>(*it));
+        }
+
+        std::size_t size() const noexcept { return offsets_.size() - 1; }
+        std::size_t num_edges() const noexcept { return targets_.size(); }
+
+        range successors(vertex_id v) const noexcept {
+            assert(v < size());
+            return { targets_.data() + offsets_[v], targets_.data() + offsets_[v + 1] };
+        }
+        std::size_t out_degree(vertex_id v) const noexcept { return offsets_[v + 1] - offsets_[v]; }
+
+        template<typename F>
+        void for_each_successor(vertex_id v, F&& f) const {
+            for (auto s : successors(v)) f(s);
+        }
+
+        // graph with all the edges reversed
+        csr_graph transposed() const {
+            std::vector<std::tuple<vertex_id, vertex_id>> edges;
+            edges.reserve(num_edges());
+            for (vertex_id v = 0; v < size(); ++v) {
+                for (auto s : successors(v)) edges.emplace_back(s, v);
+            }
+            return { size(), edges.begin(), edges.end() };
+        }
+
+    private:
+        std::vector<std::size_t> offsets_;
+        std::vector<vertex_id> targets_;
+    };
+}
+
+#endif // INCLUDE_GUARD__DDR_GRAPH_CSR_GRAPH_H__GUID_5bca35c4_8ba2_49a4_89e1_4e6aa945f93e
@@ -0,0 +1,127 @@
+#ifndef INCLUDE_GUARD__DDR_GRAPH_TOPOLOGICAL_SORT_H__GUID_333f56f0_906d_4067_ad71_f9ce357f1475
+#define INCLUDE_GUARD__DDR_GRAPH_TOPOLOGICAL_SORT_H__GUID_333f56f0_906d_4067_ad71_f9ce357f1475
+
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <functional>
+#include <cstddef>
+#include <cassert>
+
+// Graph algorithms only need g.size() and g.for_each_successor(v, f), see adjacency_matrix and csr_graph.
+namespace ddr::graph {
+
+    using vertex_id = std::size_t;
+
+    // number of predecessors of each vertex
+    template<typename Graph>
+    std::vector<std::size_t> in_degrees(const Graph& g)
+    {
+        std::vector<std::size_t> degrees(g.size(), 0);
+        for (vertex_id v = 0; v < g.size(); ++v) g.for_each_successor(v, [&degrees](vertex_id s) { ++degrees[s]; });
+        return degrees;
+    }
+
+    // Kahn's algorithm, one step at a time. A vertex is ready once all its predecessors are completed.
+    // take() extracts the first ready vertex according to the priority policy (a strict weak order, the
+    // smallest vertex goes first) and complete() releases its successors. Splitting both steps allows
+    // keeping several vertices in progress at the same time, as a scheduler of tasks does.
+    template<typename Graph, typename Compare = std::less<vertex_id>>
+    class kahn_scheduler {
+    public:
+        explicit kahn_scheduler(const Graph& g, Compare cmp = {})
+            : g_(&g), indegree_(in_degrees(g)), heap_cmp_{ std::move(cmp) }
+        {
+            for (vertex_id v = 0; v < indegree_.size(); ++v) {
+                if (indegree_[v] == 0) ready_.push_back(v);
+            }
+            std::make_heap(ready_.begin(), ready_.end(), heap_cmp_);
+        }
+
+        bool has_ready() const noexcept { return !ready_.empty(); }
+        std::size_t num_ready() const noexcept { return ready_.size(); }
+        vertex_id top() const noexcept { assert(has_ready()); return ready_.front(); }
+
+        vertex_id take() {
+            assert(has_ready());
+            std::pop_heap(ready_.begin(), ready_.end(), heap_cmp_);
+            vertex_id v = ready_.back();
+            ready_.pop_back();
+            return v;
+        }
+
+        // v must have been taken before
+        void complete(vertex_id v) {
+            ++completed_;
+            g_->for_each_successor(v, [this](vertex_id s) {
+                assert(indegree_[s] > 0);
+                if (--indegree_[s] == 0) {
+                    ready_.push_back(s);
+                    std::push_heap(ready_.begin(), ready_.end(), heap_cmp_);
+                }
+            });
+        }
+
+        std::size_t completed() const noexcept { return completed_; }
+        // all the vertices are completed, it never happens if the graph has cycles
+        bool done() const noexcept { return completed_ == indegree_.size(); }
+
+    private:
+        // std heaps keep the largest element on top
+        struct reversed {
+            Compare cmp;
+            bool operator()(vertex_id lhs, vertex_id rhs) const { return cmp(rhs, lhs); }
+        };
+
+        const Graph* g_;
+        std::vector<std::size_t> indegree_;
+        std::vector<vertex_id> ready_;
+        reversed heap_cmp_;
+        std::size_t completed_ = 0;
+    };
+
+    // Vertices in topological order, choosing among the available ones by the priority policy,
+    // or nullopt if the graph has cycles.
+    template<typename Graph, typename Compare = std::less<vertex_id>>
+    std::optional<std::vector<vertex_id>> topological_sort(const Graph& g, Compare cmp = {})
+    {
+        kahn_scheduler<Graph, Compare> scheduler{ g, std::move(cmp) };
+        std::vector<vertex_id> order;
+        order.reserve(g.size());
+        while (scheduler.has_ready()) {
+            vertex_id v = scheduler.take();
+            scheduler.complete(v);
+            order.push_back(v);
+        }
+        if (order.size() != g.size()) return std::nullopt;
+        return order;
+    }
+
+    // Vertices that can never be completed: those on a cycle and those reachable from one.
+    template<typename Graph>
+    std::vector<vertex_id> blocked_vertices(const Graph& g)
+    {
+        kahn_scheduler<Graph> scheduler{ g };
+        std::vector<bool> completed(g.size(), false);
+        while (scheduler.has_ready()) {
+            vertex_id v = scheduler.take();
+            scheduler.complete(v);
+            completed[v] = true;
+        }
+        std::vector<vertex_id> blocked;
+        for (vertex_id v = 0; v < g.size(); ++v) {
+            if (!completed[v]) blocked.push_back(v);
+        }
+        return blocked;
+    }
+
+    template<typename Graph>
+    bool has_cycle(const Graph& g)
+    {
+        kahn_scheduler<Graph> scheduler{ g };
+        while (scheduler.has_ready()) scheduler.complete(scheduler.take());
+        return !scheduler.done();
+    }
+}
+
+#endif // INCLUDE_GUARD__DDR_GRAPH_TOPOLOGICAL_SORT_H__GUID_333f56f0_906d_4067_ad71_f9ce357f1475
@@ -4,24 +4,324 @@
 #include <ddr/math/vector.h>
 
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <type_traits>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 
 namespace ddr::math {
 
-    template<typename Cell>
+    // Layout policies map a 2D index inside [0, bounds) to an offset in the grid storage.
+    // Every policy provides:
+    //   - a constructor from the grid bounds,
+    //   - bounds(), the logical size of the grid,
+    //   - storage_size(), number of cells to allocate (may include padding),
+    //   - linear_index(idx), offset of idx within the storage.
+
+    // Classical row-major layout, no padding.
+    class row_major_layout {
+    public:
+        row_major_layout() noexcept = default;
+        explicit row_major_layout(const ivec2& bounds) noexcept : bounds_(bounds) {}
+
+        const ivec2& bounds() const noexcept { return bounds_; }
+        std::size_t storage_size() const noexcept { return std::size_t(bounds_.x * bounds_.y); }
+        std::size_t linear_index(const ivec2& idx) const noexcept {
+            return std::size_t(idx.y * bounds_.x + idx.x);
+        }
+
+    private:
+        ivec2 bounds_;
+    };
+
+    // Cache-blocked layout: the grid is split into TW x TH tiles, stored in row-major order,
+    // and each tile is stored in row-major order too. Bounds are padded to a multiple of the tile size.
+    template<std::size_t TW = 8, std::size_t TH = 8>
+    class tiled_layout {
+        static_assert(TW > 0 && (TW & (TW - 1)) == 0, "tile width must be a power of two");
+        static_assert(TH > 0 && (TH & (TH - 1)) == 0, "tile height must be a power of two");
+    public:
+        tiled_layout() noexcept = default;
+        explicit tiled_layout(const ivec2& bounds) noexcept
+            : bounds_(bounds), tiles_x_((std::size_t(bounds.x) + TW - 1) / TW) {}
+
+        const ivec2& bounds() const noexcept { return bounds_; }
+        std::size_t storage_size() const noexcept {
+            std::size_t tiles_y = (std::size_t(bounds_.y) + TH - 1) / TH;
+            return tiles_x_ * tiles_y * TW * TH;
+        }
+        std::size_t linear_index(const ivec2& idx) const noexcept {
+            auto x = std::size_t(idx.x);
+            auto y = std::size_t(idx.y);
+            std::size_t tile = (y / TH) * tiles_x_ + (x / TW);
+            return tile * (TW * TH) + (y % TH) * TW + (x % TW);
+        }
+
+    private:
+        ivec2 bounds_;
+        std::size_t tiles_x_ = 0;
+    };
+
+    // Z-order (Morton) layout, interleaving the bits of x (even bits) and y (odd bits) inside squares
+    // whose side is the shorter side of the grid rounded up to a power of two. The squares are stored
+    // one after the other along the longer side. Thus each side is padded by less than the side of a
+    // square, and the storage is less than 4 times the cells of the grid whatever its aspect ratio.
+    class morton_layout {
+    public:
+        morton_layout() noexcept = default;
+        explicit morton_layout(const ivec2& bounds) noexcept : bounds_(bounds), along_x_(bounds.x >= bounds.y) {
+            assert(std::uintmax_t(bounds.x) <= (std::uintmax_t(1) << 32));
+            assert(std::uintmax_t(bounds.y) <= (std::uintmax_t(1) << 32));
+            auto shorter = std::uint64_t(std::max<std::intmax_t>(1, std::min(bounds.x, bounds.y)));
+            while ((std::uint64_t(1) << shift_) < shorter) ++shift_;
+        }
+
+        const ivec2& bounds() const noexcept { return bounds_; }
+        std::size_t storage_size() const noexcept {
+            if (bounds_.x <= 0 || bounds_.y <= 0) return 0;
+            auto longer = std::uint64_t(along_x_ ? bounds_.x : bounds_.y);
+            auto squares = (longer + (std::uint64_t(1) << shift_) - 1) >> shift_;
+            return std::size_t(squares << (2 * shift_));
+        }
+        std::size_t linear_index(const ivec2& idx) const noexcept {
+            auto x = std::uint64_t(idx.x);
+            auto y = std::uint64_t(idx.y);
+            auto mask = (std::uint64_t(1) << shift_) - 1;
+            auto square = (along_x_ ? x : y) >> shift_;
+            return std::size_t((square << (2 * shift_)) | spread(x & mask) | (spread(y & mask) << 1));
+        }
+
+    private:
+        // spread the lower 32 bits of v so that there is a zero bit between each of them
+        static constexpr std::uint64_t spread(std::uint64_t v) noexcept {
+            v &= 0x00000000ffffffffull;
+            v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+            v = (v | (v <<  8)) & 0x00ff00ff00ff00ffull;
+            v = (v | (v <<  4)) & 0x0f0f0f0f0f0f0f0full;
+            v = (v | (v <<  2)) & 0x3333333333333333ull;
+            v = (v | (v <<  1)) & 0x5555555555555555ull;
+            return v;
+        }
+
+        ivec2 bounds_;
+        bool along_x_ = true;
+        unsigned shift_ = 0;
+    };
+
+    // Non-owning strided view over an N-dimensional grid of cells.
+    // Dimension 0 is the fastest varying one, i.e., for N=2 an index is (x, y) as with ivec2.
+    // Subviews, slices and transpositions only change the extents and strides, never the cells.
+    template<typename Cell, std::size_t N>
+    class grid_view {
+        static_assert(N > 0, "grid_view must have at least one dimension");
+    public:
+        using value_type = std::remove_cv_t<Cell>;
+        using extent_type = std::array<std::intmax_t, N>;
+        using stride_type = std::array<std::ptrdiff_t, N>;
+
+        class iterator {
+        public:
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::remove_cv_t<Cell>;
+            using pointer = Cell*;
+            using reference = Cell&;
+            using iterator_category = std::forward_iterator_tag;
+
+            iterator() noexcept = default;
+            iterator(const grid_view& view, const extent_type& idx, Cell* ptr) noexcept
+                : view_(&view), idx_(idx), ptr_(ptr) {}
+
+            iterator& operator++() noexcept {
+                for (std::size_t d = 0; d < N; ++d) {
+                    ptr_ += view_->stride_[d];
+                    if (++idx_[d] < view_->size_[d] || d+1 == N) break;
+                    ptr_ -= view_->stride_[d] * std::ptrdiff_t(view_->size_[d]);
+                    idx_[d] = 0;
+                }
+                return *this;
+            }
+            iterator operator++(int) noexcept { auto cpy = *this; ++(*this); return cpy; }
+            friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept { return lhs.idx_ == rhs.idx_; }
+            friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept { return !(lhs == rhs); }
+            reference operator*() const noexcept { return *ptr_; }
+            pointer operator->() const noexcept { return ptr_; }
+            const extent_type& index() const noexcept { return idx_; }
+
+        private:
+            const grid_view* view_ = nullptr;
+            extent_type idx_{};
+            Cell* ptr_ = nullptr;
+        };
+        friend class iterator;
+
+        grid_view() noexcept = default;
+        grid_view(Cell* data, const extent_type& size, const stride_type& stride) noexcept
+            : data_(data), size_(size), stride_(stride)
+        {
+            assert(std::all_of(size.begin(), size.end(), [](auto s) { return s >= 0; }));
+        }
+
+        // dense view, where dimension 0 is contiguous
+        grid_view(Cell* data, const extent_type& size) noexcept
+            : grid_view(data, size, dense_strides(size)) {}
+
+        // allow conversion from grid_view<T, N> to grid_view<const T, N>
+        template<typename C, typename = std::enable_if_t<std::is_convertible_v<C(*)[], Cell(*)[]>>>
+        grid_view(const grid_view<C, N>& other) noexcept
+            : grid_view(other.data(), other.size(), other.strides()) {}
+
+        Cell* data() const noexcept { return data_; }
+        const extent_type& size() const noexcept { return size_; }
+        std::intmax_t size(std::size_t dim) const noexcept { return size_[dim]; }
+        const stride_type& strides() const noexcept { return stride_; }
+        std::ptrdiff_t stride(std::size_t dim) const noexcept { return stride_[dim]; }
+
+        std::size_t count() const noexcept {
+            return std::accumulate(size_.begin(), size_.end(), std::size_t(1), [](auto acc, auto s) { return acc * std::size_t(s); });
+        }
+        bool empty() const noexcept { return count() == 0; }
+
+        // true if cells are laid out densely with dimension 0 contiguous, i.e., [data(), data() + count())
+        bool is_contiguous() const noexcept { return stride_ == dense_strides(size_); }
+
+        Cell& operator[](const extent_type& idx) const noexcept {
+            std::ptrdiff_t offset = 0;
+            for (std::size_t d = 0; d < N; ++d) {
+                assert(idx[d] >= 0 && idx[d] < size_[d]);
+                offset += std::ptrdiff_t(idx[d]) * stride_[d];
+            }
+            return data_[offset];
+        }
+
+        template<std::size_t M = N, typename = std::enable_if_t<M == 2>>
+        Cell& operator[](const ivec2& idx) const noexcept { return (*this)[extent_type{ idx.x, idx.y }]; }
+
+        template<typename... Is, typename = std::enable_if_t<sizeof...(Is) == N>>
+        Cell& operator()(Is... is) const noexcept { return (*this)[extent_type{ std::intmax_t(is)... }]; }
+
+        // view of the box [start, start + size)
+        grid_view subview(const extent_type& start, const extent_type& size) const noexcept {
+            Cell* first = data_;
+            for (std::size_t d = 0; d < N; ++d) {
+                assert(start[d] >= 0 && size[d] >= 0 && start[d] + size[d] <= size_[d]);
+                if (size[d] != 0) first += std::ptrdiff_t(start[d]) * stride_[d];
+            }
+            return { first, size, stride_ };
+        }
+
+        // (N-1)-dimensional view where the coordinate `dim` is fixed at `pos`
+        template<std::size_t M = N>
+        auto slice(std::size_t dim, std::intmax_t pos) const noexcept -> std::enable_if_t<(M > 1), grid_view<Cell, M-1>> {
+            assert(dim < N);
+            assert(pos >= 0 && pos < size_[dim]);
+            typename grid_view<Cell, M-1>::extent_type size;
+            typename grid_view<Cell, M-1>::stride_type stride;
+            for (std::size_t d = 0, i = 0; d < N; ++d) {
+                if (d == dim) continue;
+                size[i] = size_[d];
+                stride[i] = stride_[d];
+                ++i;
+            }
+            return { data_ + std::ptrdiff_t(pos) * stride_[dim], size, stride };
+        }
+
+        // view with dimensions a and b swapped
+        grid_view transposed(std::size_t a = 0, std::size_t b = 1) const noexcept {
+            assert(a < N && b < N);
+            grid_view v = *this;
+            std::swap(v.size_[a], v.size_[b]);
+            std::swap(v.stride_[a], v.stride_[b]);
+            return v;
+        }
+
+        template<std::size_t M = N>
+        auto row(std::intmax_t y) const noexcept -> std::enable_if_t<M == 2, grid_view<Cell, 1>> { return slice(1, y); }
+        template<std::size_t M = N>
+        auto column(std::intmax_t x) const noexcept -> std::enable_if_t<M == 2, grid_view<Cell, 1>> { return slice(0, x); }
+
+        // the four sides of a non-empty 2D view: top row, bottom row, left column and right column.
+        // The corners belong to the rows, thus each cell is visited once unless the view is degenerate
+        // (a single row or column).
+        template<std::size_t M = N>
+        auto borders() const noexcept -> std::enable_if_t<M == 2, std::array<grid_view<Cell, 1>, 4>> {
+            assert(!empty());
+            auto inner = std::max<std::intmax_t>(size_[1] - 2, 0);
+            return {
+                row(0),
+                row(size_[1] - 1),
+                subview({ 0, std::min<std::intmax_t>(1, size_[1]) }, { 1, inner }).column(0),
+                subview({ size_[0] - 1, std::min<std::intmax_t>(1, size_[1]) }, { 1, inner }).column(0),
+            };
+        }
+
+        // calls f on each cell, dimension 0 being the innermost loop
+        template<typename F>
+        void for_each(F&& f) const {
+            if (empty()) return;
+            if (is_contiguous()) {
+                std::for_each(data_, data_ + count(), std::forward<F>(f));
+                return;
+            }
+            for_each_impl(std::integral_constant<std::size_t, N-1>{}, data_, f);
+        }
+
+        iterator begin() const noexcept { return empty() ? end() : iterator{ *this, extent_type{}, data_ }; }
+        iterator end() const noexcept {
+            extent_type idx{};
+            idx[N-1] = size_[N-1];
+            return { *this, idx, nullptr };
+        }
+
+    private:
+        static stride_type dense_strides(const extent_type& size) noexcept {
+            stride_type stride;
+            std::ptrdiff_t s = 1;
+            for (std::size_t d = 0; d < N; ++d) {
+                stride[d] = s;
+                s *= std::ptrdiff_t(size[d]);
+            }
+            return stride;
+        }
+
+        template<std::size_t D, typename F>
+        void for_each_impl(std::integral_constant<std::size_t, D>, Cell* first, F& f) const {
+            const auto n = size_[D];
+            const auto s = stride_[D];
+            if constexpr (D == 0) {
+                if (s == 1) std::for_each(first, first + n, f);
+                else for (std::intmax_t i = 0; i < n; ++i) f(first[i * s]);
+            } else {
+                for (std::intmax_t i = 0; i < n; ++i)
+                    for_each_impl(std::integral_constant<std::size_t, D-1>{}, first + i * s, f);
+            }
+        }
+
+        Cell* data_ = nullptr;
+        extent_type size_{};
+        stride_type stride_{};
+    };
+
+    // 2D grid indexed by ivec2, whose cells are stored according to Layout.
+    // Note that begin()/end() traverse the storage, i.e., cells are visited in layout order and,
+    // for padded layouts, padding cells (value initialized) are also visited.
+    // The row-major grid is the N=2 case of gridN (see below), the other layouts have no strided
+    // views as the cells of a row are not evenly spaced in their storage.
+    template<typename Cell, typename Layout = row_major_layout>
     class grid2 : private std::vector<Cell> {
         using base_type = std::vector<Cell>;
         using index_type = ivec2;
         using size_type = index_type;
     public:
+        using layout_type = Layout;
+
         grid2() noexcept = default;
         grid2(index_type size) noexcept(noexcept(Cell{}))
         {
-            base_type& vec = static_cast<base_type&>(*this);
-            assert(size[0] > 0);
-            assert(size[1] > 0);
-            vec.resize(std::size_t(size[0] * size[1]));
-            bounds_ = size;
+            resize(size);
         }
 
         void resize(const index_type& size) {
@@ -29,8 +329,8 @@ namespace ddr::math {
             vec.clear();
             assert(size[0] > 0);
             assert(size[1] > 0);
-            vec.resize(std::size_t(size[0] * size[1]));
-            bounds_ = size;
+            layout_ = layout_type{ size };
+            vec.resize(layout_.storage_size());
         }
 
         Cell& operator[](const index_type& idx)
@@ -44,18 +344,101 @@ namespace ddr::math {
         }
 
         std::size_t linear_index(const index_type& idx) const noexcept {
-            return std::size_t(idx.y * bounds_.x + idx.x);
+            assert(idx.x >= 0 && idx.x < layout_.bounds().x);
+            assert(idx.y >= 0 && idx.y < layout_.bounds().y);
+            return layout_.linear_index(idx);
         }
 
+        const size_type& size() const noexcept { return layout_.bounds(); }
+        const layout_type& layout() const noexcept { return layout_; }
+
         using base_type::begin;
         using base_type::end;
         using base_type::rbegin;
         using base_type::rend;
 
     private:
-        size_type bounds_;
+        layout_type layout_;
     };
 
+    // Owning N-dimensional dense grid, dimension 0 being contiguous (row-major for N=2).
+    template<typename Cell, std::size_t N>
+    class gridN : private std::vector<Cell> {
+        using base_type = std::vector<Cell>;
+    public:
+        using view_type = grid_view<Cell, N>;
+        using const_view_type = grid_view<const Cell, N>;
+        using extent_type = typename view_type::extent_type;
+
+        gridN() noexcept = default;
+        gridN(const extent_type& size)
+        {
+            resize(size);
+        }
+
+        void resize(const extent_type& size) {
+            base_type& vec = static_cast<base_type&>(*this);
+            vec.clear();
+            assert(std::all_of(size.begin(), size.end(), [](auto s) { return s > 0; }));
+            vec.resize(std::accumulate(size.begin(), size.end(), std::size_t(1), [](auto acc, auto s) { return acc * std::size_t(s); }));
+            size_ = size;
+        }
+
+        Cell& operator[](const extent_type& idx) { return view()[idx]; }
+        const Cell& operator[](const extent_type& idx) const { return view()[idx]; }
+
+        template<std::size_t M = N, typename = std::enable_if_t<M == 2>>
+        Cell& operator[](const ivec2& idx) { return view()[idx]; }
+        template<std::size_t M = N, typename = std::enable_if_t<M == 2>>
+        const Cell& operator[](const ivec2& idx) const { return view()[idx]; }
+
+        const extent_type& size() const noexcept { return size_; }
+
+        view_type view() noexcept { return { base_type::data(), size_ }; }
+        const_view_type view() const noexcept { return { base_type::data(), size_ }; }
+
+        using base_type::begin;
+        using base_type::end;
+        using base_type::rbegin;
+        using base_type::rend;
+
+    private:
+        extent_type size_{};
+    };
+
+
+    // Row-major 2D grid: a gridN<Cell, 2>, thus with all its views, indexed and sized by ivec2.
+    template<typename Cell>
+    class grid2<Cell, row_major_layout> : public gridN<Cell, 2> {
+        using base_type = gridN<Cell, 2>;
+        using index_type = ivec2;
+        using size_type = index_type;
+    public:
+        using layout_type = row_major_layout;
+
+        grid2() noexcept = default;
+        grid2(index_type size) : base_type({ size.x, size.y }), layout_(size) {}
+
+        void resize(const index_type& size) {
+            base_type::resize({ size.x, size.y });
+            layout_ = layout_type{ size };
+        }
+
+        using base_type::operator[];
+
+        std::size_t linear_index(const index_type& idx) const noexcept {
+            assert(idx.x >= 0 && idx.x < layout_.bounds().x);
+            assert(idx.y >= 0 && idx.y < layout_.bounds().y);
+            return layout_.linear_index(idx);
+        }
+
+        const size_type& size() const noexcept { return layout_.bounds(); }
+        const typename base_type::extent_type& extents() const noexcept { return base_type::size(); }
+        const layout_type& layout() const noexcept { return layout_; }
+
+    private:
+        layout_type layout_;
+    };
 }
 
-#endif // INCLUDE_GUARD__DDR_MATH_GRID_H__GUID_f45efb14_9d47_49c1_8b3b_652f34cda8dd
\ No newline at end of file
+#endif // INCLUDE_GUARD__DDR_MATH_GRID_H__GUID_f45efb14_9d47_49c1_8b3b_652f34cda8dd
@@ -5,26 +5,85 @@
 
 #include <functional>
 #include <iterator>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <cstddef>
+#include <cassert>
 
 namespace ddr::math {
-    struct rect {
-        ivec2 start;
-        ivec2 size;
+
+    // Axis aligned box [start, start + size). For integral scalars, it can be iterated
+    // to visit all the cells inside, dimension 0 being the fastest varying one.
+    template<typename T, std::size_t N>
+    struct hyperbox {
+        using scalar_type = T;
+        using vector_type = vec<T, N>;
+
+        vector_type start;
+        vector_type size;
+
+        constexpr vector_type last() const noexcept { return start + size; }
+        constexpr bool empty() const noexcept {
+            for (std::size_t d = 0; d < N; ++d) if (!(size[d] > 0)) return true;
+            return false;
+        }
+        constexpr scalar_type volume() const noexcept {
+            if (empty()) return scalar_type(0);
+            scalar_type v = 1;
+            for (std::size_t d = 0; d < N; ++d) v *= size[d];
+            return v;
+        }
+        constexpr bool contains(const vector_type& p) const noexcept {
+            for (std::size_t d = 0; d < N; ++d) if (p[d] < start[d] || !(p[d] < start[d] + size[d])) return false;
+            return true;
+        }
+
+        friend constexpr bool operator==(const hyperbox& lhs, const hyperbox& rhs) noexcept { return lhs.start == rhs.start && lhs.size == rhs.size; }
+        friend constexpr bool operator!=(const hyperbox& lhs, const hyperbox& rhs) noexcept { return !(lhs == rhs); }
+
+        // true if both boxes share a region of positive volume
+        friend constexpr bool intersects(const hyperbox& lhs, const hyperbox& rhs) noexcept {
+            for (std::size_t d = 0; d < N; ++d) {
+                if (!(lhs.start[d] < rhs.start[d] + rhs.size[d] && rhs.start[d] < lhs.start[d] + lhs.size[d])) return false;
+            }
+            return !lhs.empty() && !rhs.empty();
+        }
+
+        // common region of both boxes, empty (with size 0 where disjoint) if they do not intersect
+        friend constexpr hyperbox intersection(const hyperbox& lhs, const hyperbox& rhs) noexcept {
+            auto first = max(lhs.start, rhs.start);
+            auto last = min(lhs.last(), rhs.last());
+            return { first, max(last - first, vector_type{}) };
+        }
+
+        // smallest box containing both boxes
+        friend constexpr hyperbox bounding_box(const hyperbox& lhs, const hyperbox& rhs) noexcept {
+            if (lhs.empty()) return rhs;
+            if (rhs.empty()) return lhs;
+            auto first = min(lhs.start, rhs.start);
+            return { first, max(lhs.last(), rhs.last()) - first };
+        }
 
         struct iterator {
             using difference_type = std::ptrdiff_t;
-            using value_type = ivec2;
+            using value_type = vector_type;
             using pointer = const value_type*;
             using reference = const value_type&;
             using iterator_category = std::forward_iterator_tag;
 
-            std::reference_wrapper<const rect> rect_;
-            ivec2 idx_;
+            std::reference_wrapper<const hyperbox> box_;
+            vector_type idx_;
 
             iterator& operator++() noexcept {
-                auto remquo = std::div(idx_.x + 1 - rect_.get().start.x, rect_.get().size.x);
-                idx_.x = remquo.rem + rect_.get().start.x;
-                idx_.y += remquo.quot;
+                const hyperbox& box = box_.get();
+                for (std::size_t d = 0; d+1 < N; ++d) {
+                    if (++idx_[d] < box.start[d] + box.size[d]) return *this;
+                    idx_[d] = box.start[d];
+                }
+                ++idx_[N-1];
                 return *this;
             }
             iterator operator++(int) noexcept { auto cpy = *this; ++(*this); return cpy; }
@@ -35,11 +94,299 @@ namespace ddr::math {
         };
         friend struct iterator;
 
-        iterator begin() const noexcept { return { *this, start }; }
+        iterator begin() const noexcept {
+            static_assert(std::is_integral_v<T>, "only boxes with integral coordinates can be iterated");
+            return empty() ? end() : iterator{ *this, start };
+        }
         iterator end() const noexcept {
-            return { *this, { start.x, start.y + size.y } };
+            static_assert(std::is_integral_v<T>, "only boxes with integral coordinates can be iterated");
+            auto idx = start;
+            idx[N-1] += size[N-1] > 0 ? size[N-1] : 0;
+            return { *this, idx };
         }
     };
+
+    using rect = hyperbox<std::intmax_t, 2>;
+    using box3 = hyperbox<std::intmax_t, 3>;
+
+    namespace detail {
+        struct identity {
+            template<typename U> constexpr U&& operator()(U&& u) const noexcept { return std::forward<U>(u); }
+        };
+
+        template<typename It, typename Proj>
+        using projected_box_t = std::decay_t<std::invoke_result_t<Proj&, typename std::iterator_traits<It>::reference>>;
+
+        // Segment tree over the elementary intervals [coords[i], coords[i+1]) keeping, for each node,
+        // the length covered by at least j intervals, j = 0, ..., k. Covers are never pushed down,
+        // a node only accounts for the covers applied to itself and to its descendants.
+        template<typename T>
+        class coverage_tree {
+        public:
+            coverage_tree(std::vector<T> coords, std::size_t k) : coords_(std::move(coords)), k_(k) {
+                assert(coords_.size() >= 2);
+                std::size_t nodes = 4 * (coords_.size() - 1);
+                cover_.resize(nodes, 0);
+                len_.resize(nodes * (k_ + 1), T(0));
+                build(1, 0, coords_.size() - 1);
+            }
+
+            // add delta to the interval [coords[lo], coords[hi])
+            void add(std::size_t lo, std::size_t hi, int delta) noexcept { update(1, 0, coords_.size() - 1, lo, hi, delta); }
+
+            // length covered by at least k intervals
+            T covered() const noexcept { return len(1)[k_]; }
+
+        private:
+            T* len(std::size_t node) noexcept { return &len_[node * (k_ + 1)]; }
+            const T* len(std::size_t node) const noexcept { return &len_[node * (k_ + 1)]; }
+
+            void build(std::size_t node, std::size_t l, std::size_t r) noexcept {
+                if (r - l > 1) {
+                    std::size_t m = (l + r) / 2;
+                    build(2 * node, l, m);
+                    build(2 * node + 1, m, r);
+                }
+                pull(node, l, r);
+            }
+
+            void update(std::size_t node, std::size_t l, std::size_t r, std::size_t lo, std::size_t hi, int delta) noexcept {
+                if (hi <= l || r <= lo) return;
+                if (lo <= l && r <= hi) {
+                    cover_[node] += delta;
+                } else {
+                    std::size_t m = (l + r) / 2;
+                    update(2 * node, l, m, lo, hi, delta);
+                    update(2 * node + 1, m, r, lo, hi, delta);
+                }
+                pull(node, l, r);
+            }
+
+            void pull(std::size_t node, std::size_t l, std::size_t r) noexcept {
+                assert(cover_[node] >= 0);
+                auto cover = std::size_t(cover_[node]);
+                T* out = len(node);
+                for (std::size_t j = 0; j <= k_; ++j) {
+                    if (cover >= j) out[j] = coords_[r] - coords_[l];
+                    else if (r - l == 1) out[j] = T(0);
+                    else out[j] = len(2 * node)[j - cover] + len(2 * node + 1)[j - cover];
+                }
+            }
+
+            std::vector<T> coords_;
+            std::size_t k_;
+            std::vector<int> cover_;
+            std::vector<T> len_;
+        };
+
+        // Fenwick tree of counters
+        class fenwick {
+        public:
+            explicit fenwick(std::size_t n) : tree_(n + 1, 0) {}
+            void add(std::size_t i, std::ptrdiff_t delta) noexcept {
+                for (++i; i < tree_.size(); i += i & (~i + 1)) tree_[i] += delta;
+            }
+            // sum of [0, i)
+            std::ptrdiff_t prefix(std::size_t i) const noexcept {
+                std::ptrdiff_t accum = 0;
+                for (; i > 0; i -= i & (~i + 1)) accum += tree_[i];
+                return accum;
+            }
+        private:
+            std::vector<std::ptrdiff_t> tree_;
+        };
+
+        template<typename T>
+        std::vector<T> sorted_unique(std::vector<T> v) {
+            std::sort(v.begin(), v.end());
+            v.erase(std::unique(v.begin(), v.end()), v.end());
+            return v;
+        }
+
+        template<typename T>
+        std::size_t index_of(const std::vector<T>& sorted, const T& x) noexcept {
+            return std::size_t(std::distance(sorted.begin(), std::lower_bound(sorted.begin(), sorted.end(), x)));
+        }
+
+        template<typename T, std::size_t N>
+        T covered_volume(const std::vector<hyperbox<T, N>>& boxes, std::size_t k)
+        {
+            if (k == 0 || boxes.size() < k) return T(0);
+
+            if constexpr (N == 1) {
+                // sweep the endpoints, keeping how many intervals are open
+                std::vector<std::tuple<T, int>> events;
+                events.reserve(2 * boxes.size());
+                for (const auto& b : boxes) {
+                    events.emplace_back(b.start[0], 1);
+                    events.emplace_back(b.start[0] + b.size[0], -1);
+                }
+                std::sort(events.begin(), events.end());
+                T accum = 0;
+                std::size_t open = 0;
+                for (std::size_t i = 0; i < events.size(); ++i) {
+                    open = std::size_t(std::ptrdiff_t(open) + std::get<1>(events[i]));
+                    if (i + 1 < events.size() && open >= k) accum += std::get<0>(events[i + 1]) - std::get<0>(events[i]);
+                }
+                return accum;
+            } else if constexpr (N == 2) {
+                // sweep along x, keeping the coverage of the open boxes along y in a segment tree
+                std::vector<T> ys;
+                ys.reserve(2 * boxes.size());
+                for (const auto& b : boxes) { ys.push_back(b.start.y); ys.push_back(b.start.y + b.size.y); }
+                ys = sorted_unique(std::move(ys));
+
+                std::vector<std::tuple<T, int, std::size_t, std::size_t>> events; // x, delta, y0, y1
+                events.reserve(2 * boxes.size());
+                for (const auto& b : boxes) {
+                    auto y0 = index_of(ys, b.start.y);
+                    auto y1 = index_of(ys, b.start.y + b.size.y);
+                    events.emplace_back(b.start.x, 1, y0, y1);
+                    events.emplace_back(b.start.x + b.size.x, -1, y0, y1);
+                }
+                std::sort(events.begin(), events.end());
+
+                coverage_tree<T> tree{ std::move(ys), k };
+                T accum = 0;
+                for (std::size_t i = 0; i < events.size(); ++i) {
+                    const auto& [x, delta, y0, y1] = events[i];
+                    tree.add(y0, y1, delta);
+                    if (i + 1 < events.size()) accum += tree.covered() * (std::get<0>(events[i + 1]) - x);
+                }
+                return accum;
+            } else {
+                // split along the last dimension into slabs, each one being a problem of dimension N-1
+                std::vector<T> cs;
+                cs.reserve(2 * boxes.size());
+                for (const auto& b : boxes) { cs.push_back(b.start[N-1]); cs.push_back(b.start[N-1] + b.size[N-1]); }
+                cs = sorted_unique(std::move(cs));
+
+                T accum = 0;
+                std::vector<hyperbox<T, N-1>> slab;
+                for (std::size_t i = 0; i + 1 < cs.size(); ++i) {
+                    slab.clear();
+                    for (const auto& b : boxes) {
+                        if (b.start[N-1] <= cs[i] && cs[i + 1] <= b.start[N-1] + b.size[N-1]) {
+                            auto& p = slab.emplace_back();
+                            for (std::size_t d = 0; d+1 < N; ++d) { p.start[d] = b.start[d]; p.size[d] = b.size[d]; }
+                        }
+                    }
+                    accum += covered_volume(slab, k) * (cs[i + 1] - cs[i]);
+                }
+                return accum;
+            }
+        }
+    }
+
+    // Volume of the region covered by at least k of the boxes in [first, last), without rasterizing.
+    // The box of each element is obtained through proj.
+    // Cost is O(n log n) for one and two dimensions (O(n k log n) if k > 1), and each extra
+    // dimension multiplies it by the number of boxes.
+    template<typename It, typename Proj = detail::identity>
+    auto covered_volume(It first, It last, std::size_t k, Proj proj = {})
+    {
+        using box_t = detail::projected_box_t<It, Proj>;
+        std::vector<box_t> boxes;
+        for (; first != last; ++first) {
+            const box_t& b = std::invoke(proj, *first);
+            if (!b.empty()) boxes.push_back(b);
+        }
+        return detail::covered_volume(boxes, k);
+    }
+
+    // Volume of the union of the boxes in [first, last).
+    template<typename It, typename Proj = detail::identity>
+    auto union_volume(It first, It last, Proj proj = {})
+    {
+        return covered_volume(first, last, 1, std::move(proj));
+    }
+
+    // Indices (in increasing order) of the boxes in [first, last) that do not intersect any other box.
+    // Empty boxes never intersect anything.
+    // For two dimensions, the boxes are swept along x. When a box starts, it is checked against the open
+    // boxes and, when it ends, against all boxes started meanwhile. Both queries count intervals along y
+    // intersecting [y0, y1) as #(start < y1) - #(end <= y0) with Fenwick trees, giving O(n log n).
+    // Other dimensions sweep along the first one, checking each box against the open ones.
+    template<typename It, typename Proj = detail::identity>
+    std::vector<std::size_t> non_overlapping(It first, It last, Proj proj = {})
+    {
+        using box_t = detail::projected_box_t<It, Proj>;
+        using T = typename box_t::scalar_type;
+        constexpr std::size_t N = box_t::vector_type::size();
+
+        std::vector<box_t> boxes;
+        for (; first != last; ++first) boxes.push_back(std::invoke(proj, *first));
+
+        std::vector<bool> overlapped(boxes.size(), false);
+
+        // events (x, type, box), ends (type = 0) sorted before starts (type = 1)
+        std::vector<std::tuple<T, int, std::size_t>> events;
+        events.reserve(2 * boxes.size());
+        for (std::size_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].empty()) continue;
+            events.emplace_back(boxes[i].start[0], 1, i);
+            events.emplace_back(boxes[i].start[0] + boxes[i].size[0], 0, i);
+        }
+        std::sort(events.begin(), events.end());
+
+        if constexpr (N == 2) {
+            std::vector<T> ys;
+            ys.reserve(2 * boxes.size());
+            for (const auto& b : boxes) { ys.push_back(b.start.y); ys.push_back(b.start.y + b.size.y); }
+            ys = detail::sorted_unique(std::move(ys));
+
+            detail::fenwick active_starts{ ys.size() }, active_ends{ ys.size() };
+            detail::fenwick total_starts{ ys.size() }, total_ends{ ys.size() };
+            auto count = [&ys](const detail::fenwick& starts, const detail::fenwick& ends, const box_t& b) {
+                // intervals [s, e) with s < y1 and e > y0
+                return starts.prefix(detail::index_of(ys, b.start.y + b.size.y)) - ends.prefix(detail::index_of(ys, b.start.y) + 1);
+            };
+
+            std::vector<std::ptrdiff_t> started_before(boxes.size(), 0);
+            for (std::size_t i = 0; i < events.size();) {
+                // process all the events at the same x: first the boxes that end, then the ones that start
+                std::size_t j = i;
+                for (; j < events.size() && std::get<0>(events[j]) == std::get<0>(events[i]) && std::get<1>(events[j]) == 0; ++j) {
+                    std::size_t b = std::get<2>(events[j]);
+                    const auto& box = boxes[b];
+                    if (count(total_starts, total_ends, box) - started_before[b] > 1) overlapped[b] = true;
+                    active_starts.add(detail::index_of(ys, box.start.y), -1);
+                    active_ends.add(detail::index_of(ys, box.start.y + box.size.y), -1);
+                }
+                std::size_t k = j;
+                for (; k < events.size() && std::get<0>(events[k]) == std::get<0>(events[i]); ++k) {
+                    std::size_t b = std::get<2>(events[k]);
+                    const auto& box = boxes[b];
+                    if (count(active_starts, active_ends, box) > 0) overlapped[b] = true;
+                    started_before[b] = count(total_starts, total_ends, box);
+                }
+                for (std::size_t e = j; e < k; ++e) {
+                    const auto& box = boxes[std::get<2>(events[e])];
+                    auto s = detail::index_of(ys, box.start.y);
+                    auto t = detail::index_of(ys, box.start.y + box.size.y);
+                    active_starts.add(s, 1); active_ends.add(t, 1);
+                    total_starts.add(s, 1); total_ends.add(t, 1);
+                }
+                i = k;
+            }
+        } else {
+            std::vector<std::size_t> open;
+            for (const auto& [x, type, b] : events) {
+                if (type == 0) {
+                    open.erase(std::find(open.begin(), open.end(), b));
+                    continue;
+                }
+                for (std::size_t o : open) {
+                    if (intersects(boxes[o], boxes[b])) overlapped[o] = overlapped[b] = true;
+                }
+                open.push_back(b);
+            }
+        }
+
+        std::vector<std::size_t> result;
+        for (std::size_t i = 0; i < boxes.size(); ++i) if (!overlapped[i]) result.push_back(i);
+        return result;
+    }
 }
 
-#endif // INCLUDE_GUARD__DDR_MATH_HYPERBOX_H__GUID__6dfd14c0_2c9c_4305_89f9_cadd57e2e0c6
\ No newline at end of file
+#endif // INCLUDE_GUARD__DDR_MATH_HYPERBOX_H__GUID__6dfd14c0_2c9c_4305_89f9_cadd57e2e0c6
@@ -0,0 +1,89 @@
+#ifndef INCLUDE_GUARD__DDR_MATH_INTERVAL_TREE_H__GUID_ce32a21d_133e_42f1_be5c_2e63f7b80a60
+#define INCLUDE_GUARD__DDR_MATH_INTERVAL_TREE_H__GUID_ce32a21d_133e_42f1_be5c_2e63f7b80a60
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+namespace ddr::math {
+
+    // closed interval [lo, hi] carrying a value
+    template<typename T, typename V>
+    struct interval {
+        T lo;
+        T hi;
+        V value;
+    };
+
+    namespace detail {
+        // Implicit interval tree over items[l, r) sorted by lo: the root of a range is its middle item
+        // and max_hi[middle] holds the largest hi of the range, which prunes the ranges ending before a query.
+        template<typename Item, typename T>
+        T build_interval_tree(const std::vector<Item>& items, std::vector<T>& max_hi, std::size_t l, std::size_t r)
+        {
+            assert(l < r);
+            std::size_t m = l + (r - l) / 2;
+            T hi = items[m].hi;
+            if (l < m) hi = std::max(hi, build_interval_tree(items, max_hi, l, m));
+            if (m + 1 < r) hi = std::max(hi, build_interval_tree(items, max_hi, m + 1, r));
+            max_hi[m] = hi;
+            return hi;
+        }
+
+        // f(item) for each item of [l, r) overlapping [lo, hi]
+        template<typename Item, typename T, typename F>
+        void query_interval_tree(const std::vector<Item>& items, const std::vector<T>& max_hi, std::size_t l, std::size_t r, const T& lo, const T& hi, F& f)
+        {
+            while (l < r) {
+                std::size_t m = l + (r - l) / 2;
+                if (max_hi[m] < lo) return;
+                query_interval_tree(items, max_hi, l, m, lo, hi, f);
+                // items after m start after hi too
+                if (hi < items[m].lo) return;
+                if (!(items[m].hi < lo)) f(items[m]);
+                l = m + 1;
+            }
+        }
+    }
+
+    // Static interval tree: built once in O(n) (plus sorting, unless the input is already sorted by lo),
+    // it reports the k intervals overlapping a range, or containing a point, in O(min(n, (k + 1) log n)):
+    // each reported interval may cost a root to leaf path, as max_hi only prunes the ranges ending
+    // before the query (a centered interval tree would be needed for O(log n + k)).
+    template<typename T, typename V>
+    class interval_tree {
+    public:
+        using value_type = interval<T, V>;
+
+        interval_tree() = default;
+        explicit interval_tree(std::vector<value_type> items) : items_(std::move(items)), max_hi_(items_.size())
+        {
+            auto by_lo = [](const value_type& lhs, const value_type& rhs) { return lhs.lo < rhs.lo; };
+            if (!std::is_sorted(items_.begin(), items_.end(), by_lo)) std::sort(items_.begin(), items_.end(), by_lo);
+            if (!items_.empty()) detail::build_interval_tree(items_, max_hi_, 0, items_.size());
+        }
+
+        std::size_t size() const noexcept { return items_.size(); }
+        bool empty() const noexcept { return items_.empty(); }
+        // intervals sorted by lo
+        const std::vector<value_type>& items() const noexcept { return items_; }
+
+        // f(interval) for each interval overlapping [lo, hi]
+        template<typename F>
+        void overlapping(const T& lo, const T& hi, F&& f) const {
+            detail::query_interval_tree(items_, max_hi_, 0, items_.size(), lo, hi, f);
+        }
+
+        // f(interval) for each interval containing x
+        template<typename F>
+        void stabbing(const T& x, F&& f) const { overlapping(x, x, f); }
+
+    private:
+        std::vector<value_type> items_;
+        std::vector<T> max_hi_;
+    };
+}
+
+#endif // INCLUDE_GUARD__DDR_MATH_INTERVAL_TREE_H__GUID_ce32a21d_133e_42f1_be5c_2e63f7b80a60
@@ -0,0 +1,184 @@
+#ifndef INCLUDE_GUARD__DDR_MATH_ORTHOGONAL_SEGMENTS_H__GUID_fcaf3d93_2993_4627_a9cc_017bfe29d814
+#define INCLUDE_GUARD__DDR_MATH_ORTHOGONAL_SEGMENTS_H__GUID_fcaf3d93_2993_4627_a9cc_017bfe29d814
+
+#include <ddr/math/vector.h>
+#include <ddr/math/interval_tree.h>
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+namespace ddr::math {
+
+    // Axis-aligned segment on the line `line` spanning [lo, hi] along it: a horizontal segment has
+    // line = y and spans x, a vertical one has line = x and spans y.
+    template<typename T, typename V>
+    struct axis_segment {
+        T line;
+        T lo;
+        T hi;
+        V value;
+    };
+
+    // Static index of horizontal and vertical segments (closed, on a grid of T) answering:
+    //  - crossing: segments perpendicular to a query segment that intersect it, O(log^2 n + k)
+    //  - overlapping: segments collinear to a query segment that overlap it, O(log n + min(m, (k + 1) log m))
+    //  - stabbing: segments containing a point, O(log n + min(m, (k + 1) log m))
+    // where m is the number of segments on the line of the query (see interval_tree).
+    // Collinear queries group the segments of each line in an implicit interval tree. Crossing queries use
+    // a segment tree over the span axis whose nodes list their segments sorted by line, so that only the
+    // lines inside the query are visited.
+    template<typename T, typename V>
+    class orthogonal_segments {
+    public:
+        using segment_type = axis_segment<T, V>;
+
+        orthogonal_segments() = default;
+
+        // Bulk build, each family is sorted by (line, lo) unless it already is. Points (lo == hi) can go
+        // in either family. Queries that are points are taken as horizontal segments.
+        orthogonal_segments(std::vector<segment_type> horizontal, std::vector<segment_type> vertical)
+            : families_{ family{ std::move(horizontal) }, family{ std::move(vertical) } }
+        {}
+
+        // the segment from p0 to p1 (which must share a coordinate) into the right family
+        static void classify(const vec2<T>& p0, const vec2<T>& p1, V value, std::vector<segment_type>& horizontal, std::vector<segment_type>& vertical) {
+            assert(p0.x == p1.x || p0.y == p1.y);
+            if (p0.y == p1.y) horizontal.push_back({ p0.y, std::min(p0.x, p1.x), std::max(p0.x, p1.x), std::move(value) });
+            else vertical.push_back({ p0.x, std::min(p0.y, p1.y), std::max(p0.y, p1.y), std::move(value) });
+        }
+
+        const std::vector<segment_type>& horizontal() const noexcept { return families_[0].segments; }
+        const std::vector<segment_type>& vertical() const noexcept { return families_[1].segments; }
+
+        // f(segment, point) for each segment perpendicular to [p0, p1] and intersecting it at point
+        template<typename F>
+        void crossing(const vec2<T>& p0, const vec2<T>& p1, F&& f) const {
+            assert(p0.x == p1.x || p0.y == p1.y);
+            if (p0.y == p1.y) { // horizontal query, vertical segments
+                families_[1].crossing(p0.y, std::min(p0.x, p1.x), std::max(p0.x, p1.x), [&](const segment_type& s) { f(s, vec2<T>{ s.line, p0.y }); });
+            }
+            else { // vertical query, horizontal segments
+                families_[0].crossing(p0.x, std::min(p0.y, p1.y), std::max(p0.y, p1.y), [&](const segment_type& s) { f(s, vec2<T>{ p0.x, s.line }); });
+            }
+        }
+
+        // f(segment, lo, hi) for each segment collinear to [p0, p1] overlapping it in [lo, hi] (along the line)
+        template<typename F>
+        void overlapping(const vec2<T>& p0, const vec2<T>& p1, F&& f) const {
+            assert(p0.x == p1.x || p0.y == p1.y);
+            if (p0.y == p1.y) families_[0].overlapping(p0.y, std::min(p0.x, p1.x), std::max(p0.x, p1.x), f);
+            else families_[1].overlapping(p0.x, std::min(p0.y, p1.y), std::max(p0.y, p1.y), f);
+        }
+
+        // f(segment) for each segment containing p
+        template<typename F>
+        void stabbing(const vec2<T>& p, F&& f) const {
+            families_[0].overlapping(p.y, p.x, p.x, [&](const segment_type& s, const T&, const T&) { f(s); });
+            families_[1].overlapping(p.x, p.y, p.y, [&](const segment_type& s, const T&, const T&) { f(s); });
+        }
+
+    private:
+        struct family {
+            family() = default;
+            explicit family(std::vector<segment_type> segs) : segments(std::move(segs))
+            {
+                auto by_line = [](const segment_type& lhs, const segment_type& rhs) {
+                    return lhs.line < rhs.line || (!(rhs.line < lhs.line) && lhs.lo < rhs.lo);
+                };
+                if (!std::is_sorted(segments.begin(), segments.end(), by_line)) std::sort(segments.begin(), segments.end(), by_line);
+                build_lines();
+                build_span_tree();
+            }
+
+            // interval trees of each line
+            void build_lines() {
+                max_hi.resize(segments.size());
+                for (std::size_t b = 0; b < segments.size();) {
+                    std::size_t e = b + 1;
+                    while (e < segments.size() && !(segments[b].line < segments[e].line)) ++e;
+                    lines.push_back(segments[b].line);
+                    line_start.push_back(b);
+                    detail::build_interval_tree(segments, max_hi, b, e);
+                    b = e;
+                }
+                line_start.push_back(segments.size());
+            }
+
+            // Segment tree over the slots of the span axis: slot 2i is the coordinate coords[i] and
+            // slot 2i+1 the open gap between coords[i] and coords[i+1].
+            void build_span_tree() {
+                for (const auto& s : segments) { coords.push_back(s.lo); coords.push_back(s.hi); }
+                std::sort(coords.begin(), coords.end());
+                coords.erase(std::unique(coords.begin(), coords.end()), coords.end());
+                leaves = 1;
+                while (leaves < 2 * coords.size()) leaves *= 2;
+
+                // two passes over the canonical nodes of each segment: count and fill, segments are
+                // visited by line so that each node lists them sorted by line
+                node_start.assign(2 * leaves + 1, 0);
+                for (std::size_t i = 0; i < segments.size(); ++i) canonical_nodes(segments[i], [&](std::size_t node) { ++node_start[node + 1]; });
+                for (std::size_t n = 0; n < 2 * leaves; ++n) node_start[n + 1] += node_start[n];
+                node_items.resize(node_start.back());
+                std::vector<std::size_t> next(node_start.begin(), node_start.end() - 1);
+                for (std::size_t i = 0; i < segments.size(); ++i) canonical_nodes(segments[i], [&](std::size_t node) { node_items[next[node]++] = i; });
+            }
+
+            std::size_t slot_of_coord(const T& x) const noexcept {
+                return 2 * std::size_t(std::lower_bound(coords.begin(), coords.end(), x) - coords.begin());
+            }
+
+            template<typename F>
+            void canonical_nodes(const segment_type& s, F&& f) const {
+                std::size_t l = slot_of_coord(s.lo) + leaves;
+                std::size_t r = slot_of_coord(s.hi) + leaves + 1;
+                for (; l < r; l /= 2, r /= 2) {
+                    if (l & 1) f(l++);
+                    if (r & 1) f(--r);
+                }
+            }
+
+            // f(segment) for each segment spanning x whose line is in [lo, hi]
+            template<typename F>
+            void crossing(const T& x, const T& lo, const T& hi, F&& f) const {
+                if (coords.empty() || x < coords.front() || coords.back() < x) return;
+                auto it = std::lower_bound(coords.begin(), coords.end(), x);
+                std::size_t slot = 2 * std::size_t(it - coords.begin());
+                if (x < *it) --slot; // inside the gap before *it
+                for (std::size_t node = slot + leaves; node > 0; node /= 2) {
+                    auto first = node_items.begin() + std::ptrdiff_t(node_start[node]);
+                    auto last = node_items.begin() + std::ptrdiff_t(node_start[node + 1]);
+                    first = std::lower_bound(first, last, lo, [this](std::size_t i, const T& v) { return segments[i].line < v; });
+                    for (; first != last && !(hi < segments[*first].line); ++first) f(segments[*first]);
+                }
+            }
+
+            // f(segment, lo, hi) for each segment on line overlapping [lo, hi], with the common range
+            template<typename F>
+            void overlapping(const T& line, const T& lo, const T& hi, F&& f) const {
+                auto it = std::lower_bound(lines.begin(), lines.end(), line);
+                if (it == lines.end() || line < *it) return;
+                std::size_t l = std::size_t(it - lines.begin());
+                auto report = [&](const segment_type& s) { f(s, std::max(s.lo, lo), std::min(s.hi, hi)); };
+                detail::query_interval_tree(segments, max_hi, line_start[l], line_start[l + 1], lo, hi, report);
+            }
+
+            std::vector<segment_type> segments;  // sorted by (line, lo)
+            // collinear queries
+            std::vector<T> lines;
+            std::vector<std::size_t> line_start;
+            std::vector<T> max_hi;
+            // crossing queries
+            std::vector<T> coords;
+            std::size_t leaves = 0;
+            std::vector<std::size_t> node_start;
+            std::vector<std::size_t> node_items;
+        };
+
+        family families_[2];  // horizontal, vertical
+    };
+}
+
+#endif // INCLUDE_GUARD__DDR_MATH_ORTHOGONAL_SEGMENTS_H__GUID_fcaf3d93_2993_4627_a9cc_017bfe29d814
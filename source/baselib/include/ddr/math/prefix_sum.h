@@ -0,0 +1,101 @@
+#ifndef INCLUDE_GUARD__DDR_MATH_PREFIX_SUM_H__GUID_5e57b961_8403_49b3_9140_1ba8c864ebfa
+#define INCLUDE_GUARD__DDR_MATH_PREFIX_SUM_H__GUID_5e57b961_8403_49b3_9140_1ba8c864ebfa
+
+#include <ddr/math/vector.h>
+#include <ddr/math/hyperbox.h>
+#include <ddr/math/grid.h>
+
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+namespace ddr::math {
+
+    // Summed-area table of a 2D grid: built in one pass, it gives the sum of the cells of any
+    // rectangle in O(1). Sums are accumulated as T, which must be wide enough for the whole grid.
+    template<typename T>
+    class prefix_sum2 {
+    public:
+        prefix_sum2() noexcept = default;
+
+        template<typename Cell, typename Layout>
+        explicit prefix_sum2(const grid2<Cell, Layout>& cells) : size_(cells.size()), table_(cells.size() + ivec2{ 1, 1 })
+        {
+            // table_[x, y] is the sum of the cells [0, x) x [0, y), its first row and column are zeros
+            const auto w = std::size_t(size_.x) + 1;
+            T* prev = &table_[{ 0, 0 }];
+            for (std::intmax_t y = 0; y < size_.y; ++y) {
+                T* curr = prev + w;
+                T row = T(0);
+                for (std::intmax_t x = 0; x < size_.x; ++x) {
+                    row += T(cells[{ x, y }]);
+                    curr[x + 1] = row;
+                }
+                for (std::size_t x = 1; x < w; ++x) curr[x] += prev[x];
+                prev = curr;
+            }
+        }
+
+        const ivec2& size() const noexcept { return size_; }
+
+        // sum of the cells of r, which must lie inside the grid
+        T sum(const rect& r) const noexcept {
+            if (r.empty()) return T(0);
+            assert(r.start.x >= 0 && r.start.y >= 0 && r.last().x <= size_.x && r.last().y <= size_.y);
+            auto last = r.last();
+            return table_[last] - table_[{ r.start.x, last.y }] - table_[{ last.x, r.start.y }] + table_[r.start];
+        }
+
+        T total() const noexcept { return table_[size_]; }
+
+    private:
+        ivec2 size_;
+        grid2<T> table_;
+    };
+
+    // 2D difference array: adding a value to all the cells of a rectangle is O(1), the grid of the
+    // accumulated values is then materialized in a single pass over it. T must be signed.
+    template<typename T>
+    class difference2 {
+    public:
+        explicit difference2(const ivec2& size) : size_(size), diff_(size + ivec2{ 1, 1 }) {}
+
+        const ivec2& size() const noexcept { return size_; }
+
+        // adds delta to the cells of r, which must lie inside the grid
+        void add(const rect& r, T delta) noexcept {
+            if (r.empty()) return;
+            assert(r.start.x >= 0 && r.start.y >= 0 && r.last().x <= size_.x && r.last().y <= size_.y);
+            auto last = r.last();
+            diff_[r.start] += delta;
+            diff_[{ last.x, r.start.y }] -= delta;
+            diff_[{ r.start.x, last.y }] -= delta;
+            diff_[last] += delta;
+        }
+
+        // accumulated value of each cell, in a grid of any layout
+        template<typename Cell = T, typename Layout = row_major_layout>
+        grid2<Cell, Layout> materialize() const {
+            grid2<Cell, Layout> cells{ size_ };
+            const auto w = std::size_t(size_.x);
+            const T* diff = &diff_[{ 0, 0 }];
+            // sum of the rows so far of each column
+            std::vector<T> columns(w, T(0));
+            for (std::intmax_t y = 0; y < size_.y; ++y, diff += w + 1) {
+                T row = T(0);
+                for (std::size_t x = 0; x < w; ++x) {
+                    row += diff[x];
+                    columns[x] += row;
+                    cells[{ std::intmax_t(x), y }] = Cell(columns[x]);
+                }
+            }
+            return cells;
+        }
+
+    private:
+        ivec2 size_;
+        grid2<T> diff_;
+    };
+}
+
+#endif // INCLUDE_GUARD__DDR_MATH_PREFIX_SUM_H__GUID_5e57b961_8403_49b3_9140_1ba8c864ebfa
@@ -4,69 +4,189 @@
 #include <type_traits>
 #include <array>
 #include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
 
 namespace ddr::math {
 
-    template<typename T>
-    struct vec2 {
-        static_assert(std::is_trivial_v<T>, "vec2 can hold only trivial types");
-        using scalar_type = T;
+    namespace detail {
+        // vectors whose size is a power of two are aligned to their size so that they can be loaded
+        // with a single SIMD instruction, others keep the alignment of their scalars
+        template<typename T, std::size_t N>
+        constexpr std::size_t vec_alignment() noexcept {
+            constexpr std::size_t size = sizeof(T) * N;
+            return ((size & (size - 1)) == 0 && size <= 32) ? size : alignof(T);
+        }
+
+        // Named storage for the components, members() gives the pointer to each component
+        // so that indexing does not need any type punning.
+        template<typename T, std::size_t N> struct vec_storage;
 
-        vec2() noexcept : x(), y() {};
-        constexpr vec2(scalar_type x, scalar_type y) noexcept : x(x), y(y) {};
-        vec2(const vec2& other) noexcept { std::memcpy(this, &other, sizeof(vec2)); }
-        vec2& operator=(const vec2& other) noexcept { std::memcpy(this, &other, sizeof(vec2)); return *this; }
-
-        friend constexpr bool operator==(const vec2& lhs, const vec2& rhs) noexcept { return (lhs.x == rhs.x) && (lhs.y == rhs.y); /*return std::equal(lhs.data.begin(), lhs.data.end(), rhs.data.begin(), rhs.data.end());*/ }
-        friend constexpr bool operator!=(const vec2& lhs, const vec2& rhs) noexcept { return !(lhs == rhs); }
-        friend constexpr vec2 operator+(const vec2& lhs, const vec2& rhs) noexcept { return { lhs.x + rhs.x, lhs.y + rhs.y }; }
-        friend constexpr vec2 operator-(const vec2& lhs, const vec2& rhs) noexcept { return { lhs.x - rhs.x, lhs.y - rhs.y }; }
-        constexpr vec2& operator+=(const vec2& other) { x += other.x; y += other.y; return *this; }
-        constexpr vec2& operator-=(const vec2& other) { x -= other.x; y -= other.y; return *this; }
-
-        constexpr auto begin() noexcept { return data.begin(); }
-        constexpr auto end() noexcept { return data.end(); }
-        constexpr auto rbegin() noexcept { return data.rbegin(); }
-        constexpr auto rend() noexcept { return data.rend(); }
-
-        constexpr auto begin() const noexcept { return data.begin(); }
-        constexpr auto end() const noexcept { return data.end(); }
-        constexpr auto rbegin() const noexcept { return data.rbegin(); }
-        constexpr auto rend() const noexcept { return data.rend(); }
-
-        friend constexpr auto min_element(const vec2& x) { return std::min_element(x.data.begin(), x.data.end()); }
-        friend constexpr auto max_element(const vec2& x) { return std::max_element(x.data.begin(), x.data.end()); }
-        friend constexpr auto min_element(vec2& x) { return std::min_element(x.data.begin(), x.data.end()); }
-        friend constexpr auto max_element(vec2& x) { return std::max_element(x.data.begin(), x.data.end()); }
-
-        friend constexpr vec2 min(const vec2& lhs, const vec2& rhs) noexcept { return { std::min(lhs.x, rhs.x), std::min(lhs.y, rhs.y) }; }
-        friend constexpr vec2 max(const vec2& lhs, const vec2& rhs) noexcept { return { std::max(lhs.x, rhs.x), std::max(lhs.y, rhs.y) }; }
-        friend constexpr vec2 abs(const vec2& x) noexcept { return { std::abs(x.x), std::abs(x.y) }; }
-        friend constexpr scalar_type manh(const vec2& x, const vec2& y) noexcept { auto v = abs(x-y); return v.x + v.y; }
-
-        constexpr scalar_type& operator[](std::size_t i) { return data[i]; }
-        constexpr const scalar_type& operator[](std::size_t i) const { return data[i]; }
-
-        // do some nasty stuff... which obviously are undefined behaviour
-        union {
-            struct { scalar_type x; scalar_type y; };
-            std::array<scalar_type, 2> data;
+        template<typename T> struct alignas(vec_alignment<T, 1>()) vec_storage<T, 1> {
+            T x{};
+            static constexpr std::array<T vec_storage::*, 1> members() noexcept { return { &vec_storage::x }; }
+        };
+        template<typename T> struct alignas(vec_alignment<T, 2>()) vec_storage<T, 2> {
+            T x{}; T y{};
+            static constexpr std::array<T vec_storage::*, 2> members() noexcept { return { &vec_storage::x, &vec_storage::y }; }
+        };
+        template<typename T> struct alignas(vec_alignment<T, 3>()) vec_storage<T, 3> {
+            T x{}; T y{}; T z{};
+            static constexpr std::array<T vec_storage::*, 3> members() noexcept { return { &vec_storage::x, &vec_storage::y, &vec_storage::z }; }
         };
+        template<typename T> struct alignas(vec_alignment<T, 4>()) vec_storage<T, 4> {
+            T x{}; T y{}; T z{}; T w{};
+            static constexpr std::array<T vec_storage::*, 4> members() noexcept { return { &vec_storage::x, &vec_storage::y, &vec_storage::z, &vec_storage::w }; }
+        };
+
+        // random access iterator over the components of a vector (V may be const)
+        template<typename V, typename T>
+        class vec_iterator {
+        public:
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::remove_cv_t<T>;
+            using pointer = T*;
+            using reference = T&;
+            using iterator_category = std::random_access_iterator_tag;
+
+            constexpr vec_iterator() noexcept = default;
+            constexpr vec_iterator(V* v, std::size_t i) noexcept : v_(v), i_(i) {}
+
+            constexpr reference operator*() const noexcept { return (*v_)[i_]; }
+            constexpr pointer operator->() const noexcept { return &(*v_)[i_]; }
+            constexpr reference operator[](difference_type n) const noexcept { return (*v_)[std::size_t(difference_type(i_) + n)]; }
+
+            constexpr vec_iterator& operator++() noexcept { ++i_; return *this; }
+            constexpr vec_iterator& operator--() noexcept { --i_; return *this; }
+            constexpr vec_iterator operator++(int) noexcept { auto cpy = *this; ++i_; return cpy; }
+            constexpr vec_iterator operator--(int) noexcept { auto cpy = *this; --i_; return cpy; }
+            constexpr vec_iterator& operator+=(difference_type n) noexcept { i_ = std::size_t(difference_type(i_) + n); return *this; }
+            constexpr vec_iterator& operator-=(difference_type n) noexcept { i_ = std::size_t(difference_type(i_) - n); return *this; }
+            friend constexpr vec_iterator operator+(vec_iterator it, difference_type n) noexcept { return it += n; }
+            friend constexpr vec_iterator operator+(difference_type n, vec_iterator it) noexcept { return it += n; }
+            friend constexpr vec_iterator operator-(vec_iterator it, difference_type n) noexcept { return it -= n; }
+            friend constexpr difference_type operator-(const vec_iterator& lhs, const vec_iterator& rhs) noexcept { return difference_type(lhs.i_) - difference_type(rhs.i_); }
+
+            friend constexpr bool operator==(const vec_iterator& lhs, const vec_iterator& rhs) noexcept { return lhs.i_ == rhs.i_; }
+            friend constexpr bool operator!=(const vec_iterator& lhs, const vec_iterator& rhs) noexcept { return lhs.i_ != rhs.i_; }
+            friend constexpr bool operator<(const vec_iterator& lhs, const vec_iterator& rhs) noexcept { return lhs.i_ < rhs.i_; }
+            friend constexpr bool operator<=(const vec_iterator& lhs, const vec_iterator& rhs) noexcept { return lhs.i_ <= rhs.i_; }
+            friend constexpr bool operator>(const vec_iterator& lhs, const vec_iterator& rhs) noexcept { return lhs.i_ > rhs.i_; }
+            friend constexpr bool operator>=(const vec_iterator& lhs, const vec_iterator& rhs) noexcept { return lhs.i_ >= rhs.i_; }
+
+        private:
+            V* v_ = nullptr;
+            std::size_t i_ = 0;
+        };
+    }
+
+    // Trivially copyable and constexpr vector of N (1 to 4) components, accessible either by
+    // name (x, y, z, w), by index or through structured bindings.
+    template<typename T, std::size_t N>
+    struct vec : detail::vec_storage<T, N> {
+        static_assert(std::is_trivial_v<T>, "vec can hold only trivial types");
+        static_assert(N >= 1 && N <= 4, "vec can only have from 1 to 4 components");
+        using scalar_type = T;
+        using storage_type = detail::vec_storage<T, N>;
+        using iterator = detail::vec_iterator<vec, scalar_type>;
+        using const_iterator = detail::vec_iterator<const vec, const scalar_type>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr std::size_t size() noexcept { return N; }
+
+        constexpr vec() noexcept = default;
+        template<typename... Ts, typename = std::enable_if_t<sizeof...(Ts) == N && std::conjunction_v<std::is_convertible<Ts, scalar_type>...>>>
+        constexpr vec(Ts... xs) noexcept : storage_type{ scalar_type(xs)... } {}
+
+        constexpr scalar_type& operator[](std::size_t i) noexcept { return this->*(storage_type::members()[i]); }
+        constexpr const scalar_type& operator[](std::size_t i) const noexcept { return this->*(storage_type::members()[i]); }
+
+        constexpr iterator begin() noexcept { return { this, 0 }; }
+        constexpr iterator end() noexcept { return { this, N }; }
+        constexpr reverse_iterator rbegin() noexcept { return reverse_iterator{ end() }; }
+        constexpr reverse_iterator rend() noexcept { return reverse_iterator{ begin() }; }
+
+        constexpr const_iterator begin() const noexcept { return { this, 0 }; }
+        constexpr const_iterator end() const noexcept { return { this, N }; }
+        constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{ end() }; }
+        constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator{ begin() }; }
+
+        // component-wise application of f
+        template<typename F>
+        friend constexpr vec apply(const vec& v, F&& f) noexcept {
+            vec r;
+            for (std::size_t i = 0; i < N; ++i) r[i] = f(v[i]);
+            return r;
+        }
+        template<typename F>
+        friend constexpr vec apply(const vec& lhs, const vec& rhs, F&& f) noexcept {
+            vec r;
+            for (std::size_t i = 0; i < N; ++i) r[i] = f(lhs[i], rhs[i]);
+            return r;
+        }
+
+        friend constexpr bool operator==(const vec& lhs, const vec& rhs) noexcept {
+            for (std::size_t i = 0; i < N; ++i) if (lhs[i] != rhs[i]) return false;
+            return true;
+        }
+        friend constexpr bool operator!=(const vec& lhs, const vec& rhs) noexcept { return !(lhs == rhs); }
+        friend constexpr vec operator+(const vec& lhs, const vec& rhs) noexcept { return apply(lhs, rhs, [](auto a, auto b) { return scalar_type(a + b); }); }
+        friend constexpr vec operator-(const vec& lhs, const vec& rhs) noexcept { return apply(lhs, rhs, [](auto a, auto b) { return scalar_type(a - b); }); }
+        friend constexpr vec operator-(const vec& x) noexcept { return apply(x, [](auto a) { return scalar_type(-a); }); }
+        friend constexpr vec operator*(const vec& lhs, scalar_type rhs) noexcept { return apply(lhs, [rhs](auto a) { return scalar_type(a * rhs); }); }
+        friend constexpr vec operator*(scalar_type lhs, const vec& rhs) noexcept { return rhs * lhs; }
+        constexpr vec& operator+=(const vec& other) noexcept { return *this = *this + other; }
+        constexpr vec& operator-=(const vec& other) noexcept { return *this = *this - other; }
+        constexpr vec& operator*=(scalar_type other) noexcept { return *this = *this * other; }
+
+        friend constexpr auto min_element(const vec& x) { return std::min_element(x.begin(), x.end()); }
+        friend constexpr auto max_element(const vec& x) { return std::max_element(x.begin(), x.end()); }
+        friend constexpr auto min_element(vec& x) { return std::min_element(x.begin(), x.end()); }
+        friend constexpr auto max_element(vec& x) { return std::max_element(x.begin(), x.end()); }
+
+        friend constexpr vec min(const vec& lhs, const vec& rhs) noexcept { return apply(lhs, rhs, [](auto a, auto b) { return b < a ? b : a; }); }
+        friend constexpr vec max(const vec& lhs, const vec& rhs) noexcept { return apply(lhs, rhs, [](auto a, auto b) { return a < b ? b : a; }); }
+        friend constexpr vec abs(const vec& x) noexcept { return apply(x, [](auto a) { return a < 0 ? scalar_type(-a) : a; }); }
+        friend constexpr scalar_type manh(const vec& x, const vec& y) noexcept {
+            auto v = abs(x - y);
+            scalar_type accum = 0;
+            for (std::size_t i = 0; i < N; ++i) accum += v[i];
+            return accum;
+        }
     };
 
-    template<std::size_t I, typename T> constexpr T& get(vec2<T>& v) { return std::get<I>(v.data); }
-    template<std::size_t I, typename T> constexpr const T& get(const vec2<T>& v) { return std::get<I>(v.data); }
-    template<std::size_t I, typename T> constexpr T&& get(vec2<T>&& v) { return std::get<I>(std::move(v.data)); }
-    template<std::size_t I, typename T> constexpr const T&& get(const vec2<T>&& v) { return std::get<I>(std::move(v.data)); }
+    template<std::size_t I, typename T, std::size_t N> constexpr T& get(vec<T, N>& v) noexcept { static_assert(I < N); return v[I]; }
+    template<std::size_t I, typename T, std::size_t N> constexpr const T& get(const vec<T, N>& v) noexcept { static_assert(I < N); return v[I]; }
+    template<std::size_t I, typename T, std::size_t N> constexpr T&& get(vec<T, N>&& v) noexcept { static_assert(I < N); return std::move(v[I]); }
+    template<std::size_t I, typename T, std::size_t N> constexpr const T&& get(const vec<T, N>&& v) noexcept { static_assert(I < N); return std::move(v[I]); }
+
+    template<typename T> using vec2 = vec<T, 2>;
+    template<typename T> using vec3 = vec<T, 3>;
+    template<typename T> using vec4 = vec<T, 4>;
 
     using ivec2 = vec2<std::intmax_t>;
+    using ivec3 = vec3<std::intmax_t>;
+    using ivec4 = vec4<std::intmax_t>;
+    using i32vec2 = vec2<std::int32_t>;
+    using i32vec3 = vec3<std::int32_t>;
+    using i32vec4 = vec4<std::int32_t>;
+    using i64vec2 = vec2<std::int64_t>;
+    using i64vec3 = vec3<std::int64_t>;
+    using i64vec4 = vec4<std::int64_t>;
     using dvec2 = vec2<double>;
+
+    static_assert(std::is_trivially_copyable_v<ivec2>, "vectors must be trivially copyable");
+    static_assert(std::is_trivially_copyable_v<i32vec3>, "vectors must be trivially copyable");
+    static_assert(sizeof(i32vec4) == 4 * sizeof(std::int32_t), "vectors must not be padded");
+    static_assert(alignof(i32vec4) == sizeof(i32vec4), "vectors whose size is a power of two must be aligned to it");
 }
 
 // specializations
 namespace std {
-    template<typename T> struct tuple_size<ddr::math::vec2<T>> : std::integral_constant<std::size_t, 2> {};
-    template<std::size_t I, typename T> struct tuple_element<I, ddr::math::vec2<T>> { using type = T; };
+    template<typename T, std::size_t N> struct tuple_size<ddr::math::vec<T, N>> : std::integral_constant<std::size_t, N> {};
+    template<std::size_t I, typename T, std::size_t N> struct tuple_element<I, ddr::math::vec<T, N>> { using type = T; };
 }
 
-#endif // INCLUDE_GUARD__DDR_MATH_VECTOR_H__GUUID_a1e0be5d_78f5_42f7_8528_93ac0731a5fc
\ No newline at end of file
+#endif // INCLUDE_GUARD__DDR_MATH_VECTOR_H__GUID_a1e0be5d_78f5_42f7_8528_93ac0731a5fc
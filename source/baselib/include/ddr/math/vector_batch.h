@@ -0,0 +1,125 @@
+#ifndef INCLUDE_GUARD__DDR_MATH_VECTOR_BATCH_H__GUID_254724f9_230f_40de_887d_b797bddc4e5f
+#define INCLUDE_GUARD__DDR_MATH_VECTOR_BATCH_H__GUID_254724f9_230f_40de_887d_b797bddc4e5f
+
+#include <ddr/math/vector.h>
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace ddr::math {
+
+    // Structure of arrays of 2D points. Kernels below work on the coordinate arrays
+    // with branchless loops, so that the compiler is able to vectorize them.
+    template<typename T>
+    class vec2_batch {
+        static_assert(std::is_arithmetic_v<T>, "vec2_batch can hold only arithmetic types");
+    public:
+        using scalar_type = T;
+        using value_type = vec2<T>;
+
+        vec2_batch() noexcept = default;
+        template<typename It>
+        vec2_batch(It first, It last) {
+            for (; first != last; ++first) push_back(value_type{ scalar_type(first->x), scalar_type(first->y) });
+        }
+
+        void reserve(std::size_t n) { xs_.reserve(n); ys_.reserve(n); }
+        void clear() noexcept { xs_.clear(); ys_.clear(); }
+        void push_back(const value_type& p) { xs_.push_back(p.x); ys_.push_back(p.y); }
+
+        std::size_t size() const noexcept { return xs_.size(); }
+        bool empty() const noexcept { return xs_.empty(); }
+        value_type operator[](std::size_t i) const noexcept { return { xs_[i], ys_[i] }; }
+
+        const scalar_type* xs() const noexcept { return xs_.data(); }
+        const scalar_type* ys() const noexcept { return ys_.data(); }
+        scalar_type* xs() noexcept { return xs_.data(); }
+        scalar_type* ys() noexcept { return ys_.data(); }
+
+    private:
+        std::vector<scalar_type> xs_;
+        std::vector<scalar_type> ys_;
+    };
+
+    template<typename T>
+    struct argmin_result {
+        std::size_t index; // first index attaining the minimum, size() if the batch is empty
+        T value;           // the minimum
+        bool unique;       // false if the minimum is attained more than once
+    };
+
+    // out[i] = manh(points[i], p), out must hold points.size() elements
+    template<typename T>
+    void manh(const vec2_batch<T>& points, const vec2<T>& p, T* out) noexcept
+    {
+        const T* xs = points.xs();
+        const T* ys = points.ys();
+        const std::size_t n = points.size();
+        for (std::size_t i = 0; i < n; ++i) {
+            T dx = xs[i] - p.x;
+            T dy = ys[i] - p.y;
+            out[i] = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+        }
+    }
+
+    // sum of the manhattan distances from p to all points
+    template<typename T>
+    T sum_manh(const vec2_batch<T>& points, const vec2<T>& p) noexcept
+    {
+        const T* xs = points.xs();
+        const T* ys = points.ys();
+        const std::size_t n = points.size();
+        T accum = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            T dx = xs[i] - p.x;
+            T dy = ys[i] - p.y;
+            accum += (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+        }
+        return accum;
+    }
+
+    // closest point to p (manhattan distance), detecting whether it is tied with another one
+    template<typename T>
+    argmin_result<T> argmin_manh(const vec2_batch<T>& points, const vec2<T>& p) noexcept
+    {
+        const T* xs = points.xs();
+        const T* ys = points.ys();
+        const std::size_t n = points.size();
+
+        // first pass: minimum distance (min reduction)
+        T min_dist = std::numeric_limits<T>::max();
+        for (std::size_t i = 0; i < n; ++i) {
+            T dx = xs[i] - p.x;
+            T dy = ys[i] - p.y;
+            T d = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+            min_dist = d < min_dist ? d : min_dist;
+        }
+
+        // second pass: first index and number of points attaining it (min and sum reductions),
+        // indices are computed in T so that all lanes have the same width
+        assert(n < std::size_t(std::numeric_limits<T>::max()));
+        const T last = T(n);
+        T index = last;
+        T count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            T dx = xs[i] - p.x;
+            T dy = ys[i] - p.y;
+            T d = (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy);
+            T candidate = d == min_dist ? T(i) : last;
+            index = candidate < index ? candidate : index;
+            count += T(d == min_dist);
+        }
+
+        return { std::size_t(index), min_dist, count == 1 };
+    }
+
+    using ivec2_batch = vec2_batch<std::intmax_t>;
+    using i32vec2_batch = vec2_batch<std::int32_t>;
+}
+
+#endif // INCLUDE_GUARD__DDR_MATH_VECTOR_BATCH_H__GUID_254724f9_230f_40de_887d_b797bddc4e5f
@@ -0,0 +1,116 @@
+#ifndef INCLUDE_GUARD__DDR_MEMORY_OBJECT_POOL_H__GUID_a331c244_6029_4f1f_ba8d_57df7149e2b4
+#define INCLUDE_GUARD__DDR_MEMORY_OBJECT_POOL_H__GUID_a331c244_6029_4f1f_ba8d_57df7149e2b4
+
+#include <ddr/memory/stats.h>
+
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+namespace ddr::memory {
+
+    // Pool of objects of a single type. Slots are carved from blocks obtained from the upstream
+    // resource (each block doubling the previous one), and destroyed objects go to a free list
+    // which is reused first. Objects still alive when the pool is destroyed are not destroyed,
+    // only their memory is released, as it is meant for trees and graphs whose nodes die together.
+    template<typename T>
+    class object_pool {
+    public:
+        explicit object_pool(std::size_t initial_block = 64, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+            : next_block_(initial_block == 0 ? 1 : initial_block), upstream_(upstream)
+        {}
+        ~object_pool() noexcept {
+            for (auto& b : blocks_) upstream_->deallocate(b.slots, b.size * sizeof(slot), alignof(slot));
+        }
+
+        object_pool(const object_pool&) = delete;
+        object_pool& operator=(const object_pool&) = delete;
+
+        template<typename... Args>
+        T* create(Args&&... args) {
+            slot* s = acquire();
+            try {
+                return ::new (static_cast<void*>(s->storage)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                s->next = free_;
+                free_ = s;
+                stats_.on_deallocate(sizeof(slot));
+                throw;
+            }
+        }
+
+        void destroy(T* p) noexcept {
+            assert(p != nullptr);
+            p->~T();
+            slot* s = reinterpret_cast<slot*>(p);
+            s->next = free_;
+            free_ = s;
+            stats_.on_deallocate(sizeof(slot));
+        }
+
+        // reserves slots for at least n live objects
+        void reserve(std::size_t n) {
+            std::size_t available = capacity_ - stats_.in_use / sizeof(slot);
+            if (n > available) add_block(n - available);
+        }
+
+        std::size_t size() const noexcept { return stats_.in_use / sizeof(slot); }
+        std::size_t capacity() const noexcept { return capacity_; }
+        const memory_stats& stats() const noexcept { return stats_; }
+
+    private:
+        union slot {
+            slot* next;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+        struct block {
+            slot* slots;
+            std::size_t size;
+        };
+
+        slot* acquire() {
+            if (free_ == nullptr && (blocks_.empty() || used_ == blocks_.back().size)) add_block(next_block_);
+            slot* s;
+            if (free_ != nullptr) {
+                s = free_;
+                free_ = free_->next;
+            } else {
+                s = &blocks_.back().slots[used_++];
+            }
+            stats_.on_allocate(sizeof(slot));
+            return s;
+        }
+
+        // the unused slots of the last block go to the free list
+        void add_block(std::size_t size) {
+            blocks_.reserve(blocks_.size() + 1);
+            auto* slots = static_cast<slot*>(upstream_->allocate(size * sizeof(slot), alignof(slot)));
+            if (!blocks_.empty()) {
+                auto& last = blocks_.back();
+                for (; used_ < last.size; ++used_) {
+                    last.slots[used_].next = free_;
+                    free_ = &last.slots[used_];
+                }
+            }
+            blocks_.push_back({ slots, size });
+            used_ = 0;
+            capacity_ += size;
+            stats_.reserved += size * sizeof(slot);
+            next_block_ = std::max(next_block_, 2 * size);
+        }
+
+        std::vector<block> blocks_;
+        std::size_t used_ = 0;  // slots of the last block handed out at least once
+        slot* free_ = nullptr;
+        std::size_t capacity_ = 0;
+        std::size_t next_block_;
+        std::pmr::memory_resource* upstream_;
+        memory_stats stats_;
+    };
+}
+
+#endif // INCLUDE_GUARD__DDR_MEMORY_OBJECT_POOL_H__GUID_a331c244_6029_4f1f_ba8d_57df7149e2b4
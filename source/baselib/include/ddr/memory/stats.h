@@ -0,0 +1,29 @@
+#ifndef INCLUDE_GUARD__DDR_MEMORY_STATS_H__GUID_b5346872_2710_4e94_9638_f2dd7b9c8442
+#define INCLUDE_GUARD__DDR_MEMORY_STATS_H__GUID_b5346872_2710_4e94_9638_f2dd7b9c8442
+
+#include <cstddef>
+#include <algorithm>
+
+namespace ddr::memory {
+
+    // Statistics of an allocator:
+    //  - reserved: bytes obtained from the upstream allocator and not given back yet
+    //  - in_use: bytes handed out to the users and not released yet
+    //  - high_water_mark: maximum value reached by in_use
+    //  - allocations: number of allocations served
+    struct memory_stats {
+        std::size_t reserved = 0;
+        std::size_t in_use = 0;
+        std::size_t high_water_mark = 0;
+        std::size_t allocations = 0;
+
+        void on_allocate(std::size_t bytes) noexcept {
+            in_use += bytes;
+            high_water_mark = std::max(high_water_mark, in_use);
+            ++allocations;
+        }
+        void on_deallocate(std::size_t bytes) noexcept { in_use -= bytes; }
+    };
+}
+
+#endif // INCLUDE_GUARD__DDR_MEMORY_STATS_H__GUID_b5346872_2710_4e94_9638_f2dd7b9c8442
@@ -0,0 +1,81 @@
+#ifndef INCLUDE_GUARD__DDR_PARALLEL_ALGORITHM_H__GUID_48439e3f_f9d6_4134_bfef_25b0cb015df6
+#define INCLUDE_GUARD__DDR_PARALLEL_ALGORITHM_H__GUID_48439e3f_f9d6_4134_bfef_25b0cb015df6
+
+#include <ddr/parallel/thread_pool.h>
+#include <ddr/math/hyperbox.h>
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+namespace ddr::parallel {
+
+    namespace detail {
+        // number of elements per block, 0 meaning a few blocks per thread
+        inline std::size_t block_size(std::size_t n, std::size_t grain, const thread_pool& pool) noexcept {
+            if (grain != 0) return grain;
+            std::size_t blocks = 4 * pool.concurrency();
+            return std::max<std::size_t>(1, (n + blocks - 1) / blocks);
+        }
+    }
+
+    // f(begin, end) for consecutive blocks of [first, last) of at most grain elements
+    template<typename F>
+    void parallel_for_blocks(std::size_t first, std::size_t last, F&& f, std::size_t grain = 0, thread_pool& pool = default_pool())
+    {
+        if (first >= last) return;
+        std::size_t bs = detail::block_size(last - first, grain, pool);
+        if (pool.concurrency() == 1 || last - first <= bs) {
+            f(first, last);
+            return;
+        }
+        task_group group{ pool };
+        for (std::size_t b = first + bs; b < last; b += bs) {
+            std::size_t e = std::min(last, b + bs);
+            group.run([&f, b, e] { f(b, e); });
+        }
+        f(first, std::min(last, first + bs));
+        group.wait();
+    }
+
+    // f(i) for each i in [first, last)
+    template<typename F>
+    void parallel_for(std::size_t first, std::size_t last, F&& f, std::size_t grain = 0, thread_pool& pool = default_pool())
+    {
+        parallel_for_blocks(first, last, [&f](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i) f(i);
+        }, grain, pool);
+    }
+
+    // f(p) for each cell p of r, distributing the rows of r
+    template<typename F>
+    void parallel_for(const math::rect& r, F&& f, std::size_t grain_rows = 0, thread_pool& pool = default_pool())
+    {
+        if (r.empty()) return;
+        parallel_for_blocks(0, std::size_t(r.size.y), [&f, &r](std::size_t b, std::size_t e) {
+            for (auto p : math::rect{ { r.start.x, r.start.y + std::intmax_t(b) }, { r.size.x, std::intmax_t(e - b) } }) f(p);
+        }, grain_rows, pool);
+    }
+
+    // reduce(... reduce(reduce(identity, map(first)), map(first+1)) ..., map(last-1)) where
+    // reduce must be associative. Blocks are reduced in parallel and combined in order.
+    template<typename T, typename Map, typename Reduce>
+    T parallel_reduce(std::size_t first, std::size_t last, T identity, Map&& map, Reduce&& reduce, std::size_t grain = 0, thread_pool& pool = default_pool())
+    {
+        if (first >= last) return identity;
+        std::size_t bs = detail::block_size(last - first, grain, pool);
+        std::size_t nblocks = (last - first + bs - 1) / bs;
+        std::vector<T> partial(nblocks, identity);
+        parallel_for_blocks(first, last, [&](std::size_t b, std::size_t e) {
+            T acc = identity;
+            for (std::size_t i = b; i < e; ++i) acc = reduce(std::move(acc), map(i));
+            partial[(b - first) / bs] = std::move(acc);
+        }, bs, pool);
+
+        T acc = std::move(identity);
+        for (auto& p : partial) acc = reduce(std::move(acc), std::move(p));
+        return acc;
+    }
+}
+
+#endif // INCLUDE_GUARD__DDR_PARALLEL_ALGORITHM_H__GUID_48439e3f_f9d6_4134_bfef_25b0cb015df6
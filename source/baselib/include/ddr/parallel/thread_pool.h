@@ -0,0 +1,227 @@
+#ifndef INCLUDE_GUARD__DDR_PARALLEL_THREAD_POOL_H__GUID_268d82ea_4a71_4a1b_aa0c_9a47ad33f881
+#define INCLUDE_GUARD__DDR_PARALLEL_THREAD_POOL_H__GUID_268d82ea_4a71_4a1b_aa0c_9a47ad33f881
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <exception>
+#include <cstddef>
+#include <cassert>
+
+namespace ddr::parallel {
+
+    // Work-stealing thread pool. Each worker owns a deque of tasks: it pushes and pops its own tasks
+    // from the back, and steals from the front of the other deques when its own is empty.
+    // Tasks submitted from outside the pool go to an extra deque which all workers steal from.
+    // The total concurrency includes the thread waiting for the tasks, which helps executing them
+    // (see task_group::wait), thus a pool of concurrency 1 has no workers and runs everything inline.
+    class thread_pool {
+    public:
+        using task_type = std::function<void()>;
+
+        explicit thread_pool(std::size_t concurrency = hardware_concurrency())
+        {
+            if (concurrency == 0) concurrency = 1;
+            std::size_t workers = concurrency - 1;
+            queues_.reserve(workers + 1);
+            for (std::size_t i = 0; i <= workers; ++i) queues_.push_back(std::make_unique<queue>());
+            workers_.reserve(workers);
+            for (std::size_t i = 0; i < workers; ++i) workers_.emplace_back([this, i] { work(i); });
+        }
+
+        ~thread_pool() noexcept
+        {
+            {
+                std::lock_guard lock{ sleep_mutex_ };
+                stop_ = true;
+            }
+            sleep_cv_.notify_all();
+            for (auto& w : workers_) w.join();
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        static std::size_t hardware_concurrency() noexcept {
+            auto n = std::thread::hardware_concurrency();
+            return n == 0 ? 1 : n;
+        }
+
+        std::size_t concurrency() const noexcept { return workers_.size() + 1; }
+
+        // tasks must not throw, task_group takes care of it for the tasks it runs
+        void submit(task_type task)
+        {
+            std::size_t idx = (current_pool() == this) ? current_index() : queues_.size() - 1;
+            {
+                std::lock_guard lock{ queues_[idx]->mutex };
+                queues_[idx]->tasks.push_back(std::move(task));
+            }
+            pending_.fetch_add(1, std::memory_order_release);
+            if (!workers_.empty()) {
+                // take the lock so that a worker cannot miss the notification between checking and sleeping
+                { std::lock_guard lock{ sleep_mutex_ }; }
+                sleep_cv_.notify_one();
+            }
+        }
+
+        // executes one pending task, if any, returning whether it did
+        bool run_one()
+        {
+            std::size_t idx = (current_pool() == this) ? current_index() : queues_.size() - 1;
+            task_type task;
+            if (!pop(idx, task)) return false;
+            task();
+            return true;
+        }
+
+    private:
+        struct queue {
+            std::mutex mutex;
+            std::deque<task_type> tasks;
+        };
+
+        static const thread_pool*& current_pool() noexcept { static thread_local const thread_pool* pool = nullptr; return pool; }
+        static std::size_t& current_index() noexcept { static thread_local std::size_t index = 0; return index; }
+
+        // own tasks are popped LIFO (back), stolen tasks FIFO (front)
+        bool pop(std::size_t idx, task_type& task)
+        {
+            if (pending_.load(std::memory_order_acquire) == 0) return false;
+            {
+                auto& q = *queues_[idx];
+                std::lock_guard lock{ q.mutex };
+                if (!q.tasks.empty()) {
+                    task = std::move(q.tasks.back());
+                    q.tasks.pop_back();
+                    pending_.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            for (std::size_t i = 1; i < queues_.size(); ++i) {
+                auto& q = *queues_[(idx + i) % queues_.size()];
+                std::lock_guard lock{ q.mutex };
+                if (!q.tasks.empty()) {
+                    task = std::move(q.tasks.front());
+                    q.tasks.pop_front();
+                    pending_.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void work(std::size_t idx)
+        {
+            current_pool() = this;
+            current_index() = idx;
+            task_type task;
+            while (true) {
+                if (pop(idx, task)) {
+                    task();
+                    task = nullptr;
+                    continue;
+                }
+                std::unique_lock lock{ sleep_mutex_ };
+                sleep_cv_.wait(lock, [this] { return stop_ || pending_.load(std::memory_order_acquire) > 0; });
+                if (stop_) return;
+            }
+        }
+
+        std::vector<std::unique_ptr<queue>> queues_;
+        std::vector<std::thread> workers_;
+        std::atomic<std::size_t> pending_{ 0 };
+        std::mutex sleep_mutex_;
+        std::condition_variable sleep_cv_;
+        bool stop_ = false;
+    };
+
+    namespace detail {
+        inline std::atomic<std::size_t>& default_concurrency() noexcept {
+            static std::atomic<std::size_t> concurrency{ 0 };
+            return concurrency;
+        }
+    }
+
+    // Sets the concurrency of the default pool (0 means the hardware concurrency).
+    // It only has effect if called before the first use of default_pool().
+    inline void set_default_concurrency(std::size_t concurrency) noexcept
+    {
+        detail::default_concurrency() = concurrency;
+    }
+
+    // pool shared by all the users that do not want to manage their own threads
+    inline thread_pool& default_pool()
+    {
+        static thread_pool pool{ detail::default_concurrency() != 0 ? detail::default_concurrency().load() : thread_pool::hardware_concurrency() };
+        return pool;
+    }
+
+    // Fork/join: tasks are forked with run() and joined with wait(). While waiting, the calling
+    // thread executes pending tasks of the pool, thus groups can be nested inside tasks.
+    // The first exception thrown by a task is rethrown by wait().
+    class task_group {
+    public:
+        explicit task_group(thread_pool& pool = default_pool()) noexcept : pool_(pool) {}
+        ~task_group() noexcept { wait_all(); }
+
+        task_group(const task_group&) = delete;
+        task_group& operator=(const task_group&) = delete;
+
+        template<typename F>
+        void run(F&& f)
+        {
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            pool_.submit([this, f = std::forward<F>(f)]() mutable {
+                try {
+                    f();
+                } catch (...) {
+                    std::lock_guard lock{ error_mutex_ };
+                    if (!error_) error_ = std::current_exception();
+                }
+                pending_.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        void wait()
+        {
+            wait_all();
+            std::exception_ptr error;
+            {
+                std::lock_guard lock{ error_mutex_ };
+                std::swap(error, error_);
+            }
+            if (error) std::rethrow_exception(error);
+        }
+
+    private:
+        void wait_all() noexcept
+        {
+            while (pending_.load(std::memory_order_acquire) > 0) {
+                if (!pool_.run_one()) std::this_thread::yield();
+            }
+        }
+
+        thread_pool& pool_;
+        std::atomic<std::size_t> pending_{ 0 };
+        std::mutex error_mutex_;
+        std::exception_ptr error_;
+    };
+
+    // runs f and g in parallel, returning when both have finished
+    template<typename F, typename G>
+    void fork_join(F&& f, G&& g, thread_pool& pool = default_pool())
+    {
+        task_group group{ pool };
+        group.run(std::forward<G>(g));
+        f();
+        group.wait();
+    }
+}
+
+#endif // INCLUDE_GUARD__DDR_PARALLEL_THREAD_POOL_H__GUID_268d82ea_4a71_4a1b_aa0c_9a47ad33f881
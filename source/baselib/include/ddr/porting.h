@@ -1,4 +1,13 @@
+#ifndef INCLUDE_GUARD__DDR_PORTING_H__GUID_011a74f3_ed53_4e23_8a80_d2b6d8943d77
+#define INCLUDE_GUARD__DDR_PORTING_H__GUID_011a74f3_ed53_4e23_8a80_d2b6d8943d77
+
 #include <type_traits>
+#include <cstdint>
+#include <limits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
 
 namespace stdx {
 
@@ -9,4 +18,59 @@ namespace stdx {
 
     template<typename T>
     using remove_cvref_t = typename remove_cvref<T>::type;
-}
\ No newline at end of file
+
+    // number of trailing zero bits, x must not be 0 (unlike C++20 std::countr_zero)
+    inline int countr_zero(std::uint64_t x) noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long idx;
+        _BitScanForward64(&idx, x);
+        return int(idx);
+#else
+        return __builtin_ctzll(x);
+#endif
+    }
+
+    // number of bits set (C++20 std::popcount)
+    inline int popcount(std::uint64_t x) noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return int(__popcnt64(x));
+#else
+        return __builtin_popcountll(x);
+#endif
+    }
+
+    // result = x + y, returns whether it overflowed, then result is unspecified (C++26 ckd_add)
+    inline bool add_overflow(std::intmax_t x, std::intmax_t y, std::intmax_t& result) noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        constexpr auto max = std::numeric_limits<std::intmax_t>::max();
+        constexpr auto min = std::numeric_limits<std::intmax_t>::min();
+        if ((y > 0 && x > max - y) || (y < 0 && x < min - y)) return true;
+        result = x + y;
+        return false;
+#else
+        return __builtin_add_overflow(x, y, &result);
+#endif
+    }
+
+    // result = x * y, returns whether it overflowed, then result is unspecified (C++26 ckd_mul)
+    inline bool mul_overflow(std::intmax_t x, std::intmax_t y, std::intmax_t& result) noexcept
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        constexpr auto max = std::numeric_limits<std::intmax_t>::max();
+        constexpr auto min = std::numeric_limits<std::intmax_t>::min();
+        bool overflow = x > 0
+            ? (y > 0 ? x > max / y : y < min / x)
+            : (y > 0 ? x < min / y : x != 0 && y < max / x);
+        if (overflow) return true;
+        result = x * y;
+        return false;
+#else
+        return __builtin_mul_overflow(x, y, &result);
+#endif
+    }
+}
+
+#endif // INCLUDE_GUARD__DDR_PORTING_H__GUID_011a74f3_ed53_4e23_8a80_d2b6d8943d77
@@ -0,0 +1,78 @@
+#ifndef INCLUDE_GUARD__DDR_SIM_EVENT_QUEUE_H__GUID_f60d03ca_7c53_425a_b0c6_0350586d14ff
+#define INCLUDE_GUARD__DDR_SIM_EVENT_QUEUE_H__GUID_f60d03ca_7c53_425a_b0c6_0350586d14ff
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace ddr::sim {
+
+    // Pending events of a discrete-event simulation, ordered by time. Events of the same time
+    // come out in the order they were scheduled, so that simulations are deterministic.
+    // The clock (now()) is the time of the last event popped.
+    template<typename Event, typename Time = std::size_t>
+    class event_queue {
+    public:
+        using event_type = Event;
+        using time_type = Time;
+
+        explicit event_queue(Time start = Time{}) : now_(start) {}
+
+        bool empty() const noexcept { return heap_.empty(); }
+        std::size_t size() const noexcept { return heap_.size(); }
+        Time now() const noexcept { return now_; }
+        Time next_time() const noexcept { assert(!empty()); return heap_.front().time; }
+
+        void reserve(std::size_t n) { heap_.reserve(n); }
+
+        void schedule_at(Time time, Event e) {
+            assert(!(time < now_));
+            heap_.push_back({ time, seq_++, std::move(e) });
+            std::push_heap(heap_.begin(), heap_.end(), later{});
+        }
+        void schedule_in(Time delay, Event e) { schedule_at(now_ + delay, std::move(e)); }
+
+        // advances the clock to the next event and extracts it
+        Event pop() {
+            assert(!empty());
+            std::pop_heap(heap_.begin(), heap_.end(), later{});
+            entry e = std::move(heap_.back());
+            heap_.pop_back();
+            now_ = e.time;
+            return std::move(e.event);
+        }
+
+        // f(event) for all the events of the next time, f may schedule new events (also for that time)
+        template<typename F>
+        void pop_simultaneous(F&& f) {
+            assert(!empty());
+            Time t = next_time();
+            while (!empty() && !(t < next_time())) f(pop());
+        }
+
+    private:
+        struct entry {
+            Time time;
+            std::uint64_t seq;
+            Event event;
+        };
+
+        // std heaps keep the largest element on top
+        struct later {
+            bool operator()(const entry& lhs, const entry& rhs) const noexcept {
+                if (rhs.time < lhs.time) return true;
+                if (lhs.time < rhs.time) return false;
+                return lhs.seq > rhs.seq;
+            }
+        };
+
+        std::vector<entry> heap_;
+        std::uint64_t seq_ = 0;
+        Time now_;
+    };
+}
+
+#endif // INCLUDE_GUARD__DDR_SIM_EVENT_QUEUE_H__GUID_f60d03ca_7c53_425a_b0c6_0350586d14ff
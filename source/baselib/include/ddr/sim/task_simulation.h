@@ -0,0 +1,91 @@
+#ifndef INCLUDE_GUARD__DDR_SIM_TASK_SIMULATION_H__GUID_ef08257c_e236_48f7_ae36_5c0b9f7e434c
+#define INCLUDE_GUARD__DDR_SIM_TASK_SIMULATION_H__GUID_ef08257c_e236_48f7_ae36_5c0b9f7e434c
+
+#include <ddr/sim/event_queue.h>
+
+#include <vector>
+#include <optional>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+
+namespace ddr::sim {
+
+    using worker_id = std::size_t;
+
+    // Identical resources that are either idle or busy. Idle workers are handed out last released first.
+    class worker_pool {
+    public:
+        explicit worker_pool(std::size_t workers) : busy_(workers, false) {
+            idle_.reserve(workers);
+            for (std::size_t w = workers; w-- > 0;) idle_.push_back(w);
+        }
+
+        std::size_t size() const noexcept { return busy_.size(); }
+        std::size_t num_idle() const noexcept { return idle_.size(); }
+        bool has_idle() const noexcept { return !idle_.empty(); }
+        bool busy(worker_id w) const noexcept { return busy_[w]; }
+
+        worker_id acquire() noexcept {
+            assert(has_idle());
+            worker_id w = idle_.back();
+            idle_.pop_back();
+            busy_[w] = true;
+            return w;
+        }
+        void release(worker_id w) {
+            assert(busy_[w]);
+            busy_[w] = false;
+            idle_.push_back(w);
+        }
+
+    private:
+        std::vector<bool> busy_;
+        std::vector<worker_id> idle_;
+    };
+
+    // Runs the tasks handed out by the ready queue on the given number of workers, returning the time at
+    // which the last one finishes. The ready queue decides which task goes first and which tasks become
+    // ready when another completes: it must provide has_ready(), take() and complete(task), as
+    // graph::kahn_scheduler does. At any time, all the tasks finishing then complete before idle workers
+    // take new tasks. Each task costs O(log) operations on the event heap, plus those of the ready queue.
+    // on_start(task, worker, time) is called whenever a worker takes a task.
+    template<typename ReadyQueue, typename Duration, typename OnStart>
+    auto simulate_tasks(ReadyQueue& ready, std::size_t workers, Duration&& duration, OnStart&& on_start)
+    {
+        using task_type = decltype(ready.take());
+        using time_type = decltype(duration(std::declval<task_type>()));
+        struct finish {
+            task_type task;
+            worker_id worker;
+        };
+
+        assert(workers > 0);
+        worker_pool pool{ workers };
+        event_queue<finish, time_type> events;
+        events.reserve(workers);
+
+        while (true) {
+            while (pool.has_idle() && ready.has_ready()) {
+                task_type task = ready.take();
+                worker_id w = pool.acquire();
+                on_start(task, w, events.now());
+                events.schedule_in(duration(task), finish{ std::move(task), w });
+            }
+            if (events.empty()) break;
+            events.pop_simultaneous([&](finish f) {
+                pool.release(f.worker);
+                ready.complete(std::move(f.task));
+            });
+        }
+        return events.now();
+    }
+
+    template<typename ReadyQueue, typename Duration>
+    auto simulate_tasks(ReadyQueue& ready, std::size_t workers, Duration&& duration)
+    {
+        return simulate_tasks(ready, workers, std::forward<Duration>(duration), [](const auto&, worker_id, const auto&) {});
+    }
+}
+
+#endif // INCLUDE_GUARD__DDR_SIM_TASK_SIMULATION_H__GUID_ef08257c_e236_48f7_ae36_5c0b9f7e434c
@@ -0,0 +1,108 @@
+// Compares ddr::data::flat_hash_set and flat_hash_map with their std::unordered counterparts on the
+// key distributions of the solvers:
+//  - frequencies: running sums of small random changes, as the frequencies of 2018 d01
+//  - guard ids: few small ids looked up many times, as the guards of 2018 d04
+//  - hashes: uniformly distributed 64-bit values, as the deletion hashes of 2018 d02
+// usage: flat_hash_benchmark [number of keys, 1000000 by default]
+
+#include <ddr/data/flat_hash.h>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <unordered_set>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+    using clock_type = std::chrono::steady_clock;
+
+    template<typename F>
+    double time_ms(F&& f)
+    {
+        auto start = clock_type::now();
+        f();
+        return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+    }
+
+    std::vector<std::int64_t> frequencies(std::size_t n, std::mt19937_64& rng)
+    {
+        std::uniform_int_distribution<std::int64_t> change{ -100000, 100000 };
+        std::vector<std::int64_t> keys(n);
+        std::int64_t frequency = 0;
+        for (auto& k : keys) k = frequency += change(rng);
+        return keys;
+    }
+
+    std::vector<std::int64_t> guard_ids(std::size_t n, std::mt19937_64& rng)
+    {
+        std::uniform_int_distribution<std::int64_t> id{ 1, 4000 };
+        std::vector<std::int64_t> keys(n);
+        for (auto& k : keys) k = id(rng);
+        return keys;
+    }
+
+    std::vector<std::int64_t> hashes(std::size_t n, std::mt19937_64& rng)
+    {
+        std::vector<std::int64_t> keys(n);
+        for (auto& k : keys) k = std::int64_t(rng());
+        return keys;
+    }
+
+    // inserts the keys into a set, then looks up as many keys, half of them missing
+    template<typename Set>
+    void bench_set(const char* name, const std::vector<std::int64_t>& keys, const std::vector<std::int64_t>& queries)
+    {
+        Set set;
+        std::size_t found = 0;
+        double insert = time_ms([&]() { for (auto k : keys) found += set.insert(k).second; });
+        double lookup = time_ms([&]() { for (auto q : queries) found += set.count(q); });
+        std::cout << "  " << std::left << std::setw(24) << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(1) << insert << " ms insert"
+            << std::setw(10) << lookup << " ms lookup   (" << found << ")\n";
+    }
+
+    // counts the occurrences of the keys in a map
+    template<typename Map>
+    void bench_map(const char* name, const std::vector<std::int64_t>& keys)
+    {
+        Map map;
+        double count = time_ms([&]() { for (auto k : keys) ++map[k]; });
+        std::cout << "  " << std::left << std::setw(24) << name << std::right
+            << std::setw(10) << std::fixed << std::setprecision(1) << count << " ms count    (" << map.size() << ")\n";
+    }
+
+    void bench(const char* distribution, const std::vector<std::int64_t>& keys, std::mt19937_64& rng)
+    {
+        std::vector<std::int64_t> queries(keys.size());
+        std::uniform_int_distribution<std::size_t> pick{ 0, keys.size() - 1 };
+        for (std::size_t i = 0; i < queries.size(); ++i) queries[i] = i % 2 ? keys[pick(rng)] : std::int64_t(rng());
+
+        std::cout << distribution << ":\n";
+        bench_set<ddr::data::flat_hash_set<std::int64_t>>("flat_hash_set", keys, queries);
+        bench_set<std::unordered_set<std::int64_t>>("std::unordered_set", keys, queries);
+        bench_map<ddr::data::flat_hash_map<std::int64_t, std::size_t>>("flat_hash_map", keys);
+        bench_map<std::unordered_map<std::int64_t, std::size_t>>("std::unordered_map", keys);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t n = 1000000;
+    if (argc > 1) n = std::size_t(std::strtoull(argv[1], nullptr, 10));
+    if (n == 0) {
+        std::cerr << "usage: " << argv[0] << " [number of keys]\n";
+        return 1;
+    }
+
+    std::mt19937_64 rng{ 2018 };
+    bench("frequencies", frequencies(n, rng), rng);
+    bench("guard ids", guard_ids(n, rng), rng);
+    bench("hashes", hashes(n, rng), rng);
+    return 0;
+}